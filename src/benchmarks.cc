@@ -0,0 +1,317 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "s_containers.h"
+#include "s_containersplus.h"
+
+// every heap allocation of the process goes through here, so a lookup loop
+// that leaves the counter untouched allocated nothing. The concurrent
+// benchmarks allocate from several threads at once.
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void* memory{std::malloc(size ? size : 1)};
+  if (!memory) throw std::bad_alloc();
+  return memory;
+}
+
+// operator new above takes its memory from malloc, which GCC cannot see
+// from here
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+constexpr int kElements{100000};
+constexpr int kRounds{10};
+
+// long enough to defeat the small string optimisation, so that any copy of
+// a key would show up as an allocation
+std::string MakeKey(int index) {
+  return "request/route/number/" + std::to_string(index * 7919 % kElements);
+}
+
+// runs the lookups over every key and reports time and allocations per call
+template <class Lookup>
+bool Measure(const char* name, const std::vector<std::string>& keys,
+             Lookup lookup) {
+  size_t hits{0};
+  size_t before{allocations};
+  auto start{std::chrono::steady_clock::now()};
+  for (int round = 0; round < kRounds; ++round)
+    for (const std::string& key : keys) hits += lookup(key);
+  auto finish{std::chrono::steady_clock::now()};
+  size_t allocated{allocations - before};
+
+  double calls{static_cast<double>(keys.size()) * kRounds};
+  double nanoseconds{
+      std::chrono::duration<double, std::nano>(finish - start).count()};
+  std::printf("%-28s %8.1f ns/call %6.3f allocations/call (%zu hits)\n",
+              name, nanoseconds / calls, allocated / calls, hits);
+  return allocated == 0;
+}
+
+template <class Body>
+double NanosecondsPer(size_t calls, Body body) {
+  auto start{std::chrono::steady_clock::now()};
+  body();
+  auto finish{std::chrono::steady_clock::now()};
+  return std::chrono::duration<double, std::nano>(finish - start).count() /
+         static_cast<double>(calls);
+}
+
+// filling, point lookups and one ordered scan over integer keys
+template <class Container, class Fill>
+void CompareOrdered(const char* name, const std::vector<int>& keys,
+                    Fill fill) {
+  Container container;
+  double insert{NanosecondsPer(keys.size(), [&] { fill(container); })};
+  size_t hits{0};
+  double lookup{NanosecondsPer(keys.size(), [&] {
+    for (int key : keys) hits += container.contains(key);
+  })};
+  long long sum{0};
+  double scan{NanosecondsPer(keys.size(), [&] {
+    for (auto it = container.begin(); it != container.end(); ++it) sum += *it;
+  })};
+  std::printf("%-14s insert %7.1f lookup %7.1f scan %5.1f ns/key (%zu %lld)\n",
+              name, insert, lookup, scan, hits, sum);
+}
+
+// one insert per key in random order
+template <class Container>
+void CompareOrdered(const char* name, const std::vector<int>& keys) {
+  CompareOrdered<Container>(name, keys, [&](Container& container) {
+    for (int key : keys) container.insert(key);
+  });
+}
+
+// inserts, lookups of present and of absent keys, then erasing every key
+template <class Map>
+void CompareHashed(const char* name, const std::vector<int>& keys) {
+  Map map;
+  double insert{NanosecondsPer(keys.size(), [&] {
+    for (int key : keys) map.insert({key, key});
+  })};
+  size_t hits{0};
+  double hit{NanosecondsPer(keys.size(), [&] {
+    for (int key : keys) hits += map.find(key) != map.end();
+  })};
+  double miss{NanosecondsPer(keys.size(), [&] {
+    for (int key : keys) hits += map.find(-key - 1) != map.end();
+  })};
+  double erase{NanosecondsPer(keys.size(), [&] {
+    for (int key : keys) map.erase(map.find(key));
+  })};
+  std::printf("%-20s insert %6.1f hit %6.1f miss %6.1f erase %6.1f ns/key "
+              "(%zu)\n",
+              name, insert, hit, miss, erase, hits);
+}
+
+// one s21::map behind one mutex, the arrangement concurrent_map replaces
+class LockedMap {
+ public:
+  bool insert_or_assign(int key, int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return map_.insert_or_assign(key, value).second;
+  }
+
+  bool contains(int key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return map_.contains(key);
+  }
+
+ private:
+  std::mutex mutex_;
+  s21::map<int, int> map_;
+};
+
+// every thread runs the same mix of nine lookups to one write over its own
+// stretch of the keys; reports million operations per second in total
+template <class Map>
+void CompareConcurrent(const char* name, const std::vector<int>& keys) {
+  constexpr size_t kOperations{400000};
+  std::printf("%-20s", name);
+  for (size_t threads : {1, 2, 4, 8}) {
+    Map map;
+    for (size_t i = 0; i < keys.size(); i += 2)
+      map.insert_or_assign(keys[i], 0);
+    std::atomic<size_t> hits{0};
+    double nanoseconds{NanosecondsPer(1, [&] {
+      std::vector<std::thread> workers;
+      for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+          size_t found{0};
+          for (size_t i = 0; i < kOperations / threads; ++i) {
+            int key{keys[(t * 7919 + i * 31) % keys.size()]};
+            if (i % 10 == 0) {
+              map.insert_or_assign(key, static_cast<int>(i));
+            } else {
+              found += map.contains(key);
+            }
+          }
+          hits += found;
+        });
+      }
+      for (std::thread& worker : workers) worker.join();
+    })};
+    std::printf(" %zu threads %6.2f", threads, kOperations / nanoseconds * 1e3);
+  }
+  std::printf(" Mops/s\n");
+}
+}  // namespace
+
+int main() {
+  std::vector<std::string> keys;
+  s21::set<std::string> set;
+  s21::map<std::string, int> map;
+  for (int i = 0; i < kElements; ++i) {
+    keys.push_back(MakeKey(i));
+    set.insert(keys.back());
+    map.insert(keys.back(), i);
+  }
+
+  bool clean{true};
+  clean &= Measure("set::find", keys, [&](const std::string& key) {
+    return set.find(key) != set.end();
+  });
+  clean &= Measure("set::contains", keys, [&](const std::string& key) {
+    return set.contains(key);
+  });
+  clean &= Measure("set::insert (present)", keys, [&](const std::string& key) {
+    return !set.insert(key).second;
+  });
+  clean &= Measure("map::find", keys, [&](const std::string& key) {
+    return map.find(key) != map.end();
+  });
+  clean &= Measure("map::at", keys, [&](const std::string& key) {
+    return map.at(key) >= 0;
+  });
+  clean &= Measure("map::operator[] (present)", keys,
+                   [&](const std::string& key) { return map[key] >= 0; });
+  clean &= Measure("map::insert (present)", keys, [&](const std::string& key) {
+    return !map.insert(key, 0).second;
+  });
+
+  if (!clean) std::printf("lookups must not allocate\n");
+
+  std::vector<int> numbers;
+  for (long long i = 0; i < 1000000; ++i)
+    numbers.push_back(static_cast<int>(i * 7919 % 1000003));
+  std::printf("\n%zu random int keys\n", numbers.size());
+  CompareOrdered<s21::set<int>>("set", numbers);
+  CompareOrdered<s21::btree_set<int>>("btree_set", numbers);
+  CompareOrdered<s21::btree_set<int, std::less<int>, 16>>("btree_set<16>",
+                                                          numbers);
+  // a flat set filled key by key shifts half of itself on every insert
+  CompareOrdered<s21::flat_set<int>>(
+      "flat_set", numbers, [&](s21::flat_set<int>& container) {
+        container.insert_range(numbers.begin(), numbers.end());
+      });
+
+  // the cold start: one sort and a linear build instead of an insert per
+  // key, on every hardware thread. Its lookups run in a different order
+  // from the allocations, which the rows above get for free.
+  CompareOrdered<s21::set<int>>(
+      "from_unsorted", numbers, [&](s21::set<int>& container) {
+        container = s21::set<int>::from_unsorted(numbers.begin(),
+                                                 numbers.end());
+      });
+
+  // freezing a filled set, then looking up in the snapshot
+  s21::set<int> source(numbers.begin(), numbers.end());
+  CompareOrdered<s21::frozen_set<int>>(
+      "frozen_set", numbers,
+      [&](s21::frozen_set<int>& container) { container = source.freeze(); });
+
+  // small enough to stay in cache, where the node search itself counts
+  std::vector<int> few(numbers.begin(), numbers.begin() + 10000);
+  std::printf("\n%zu random int keys\n", few.size());
+  CompareOrdered<s21::set<int>>("set", few);
+  CompareOrdered<s21::btree_set<int>>("btree_set", few);
+  CompareOrdered<s21::flat_set<int>>(
+      "flat_set", few, [&](s21::flat_set<int>& container) {
+        container.insert_range(few.begin(), few.end());
+      });
+
+  std::printf("\n%zu random int keys, hashed\n", numbers.size());
+  CompareHashed<s21::map<int, int>>("s21::map", numbers);
+  CompareHashed<std::unordered_map<int, int>>("std::unordered_map", numbers);
+  CompareHashed<s21::unordered_map<int, int>>("s21::unordered_map", numbers);
+
+  // scales with the cores of the machine it runs on
+  std::printf("\n%u hardware threads, 90%% lookups\n",
+              std::thread::hardware_concurrency());
+  std::vector<int> shared(numbers.begin(), numbers.begin() + 100000);
+  CompareConcurrent<LockedMap>("map + mutex", shared);
+  CompareConcurrent<s21::concurrent_map<int, int>>("concurrent_map", shared);
+  CompareConcurrent<s21::concurrent_rw_map<int, int>>("concurrent_rw_map",
+                                                      shared);
+
+  // an aggregation: the iterator climbs parent links on one thread, the
+  // reduce walks subtrees with a stack on every thread
+  s21::map<int, int> totals;
+  for (int key : numbers) totals.insert(key, key % 100);
+  long long serial_sum{0};
+  long long parallel_sum{0};
+  double serial{NanosecondsPer(numbers.size(), [&] {
+    for (auto it = totals.begin(); it != totals.end(); ++it)
+      serial_sum += it->second;
+  })};
+  double reduced{NanosecondsPer(numbers.size(), [&] {
+    parallel_sum = totals.parallel_reduce(
+        0LL,
+        [](long long sum, const std::pair<int, int>& item) {
+          return sum + item.second;
+        },
+        [](long long a, long long b) { return a + b; });
+  })};
+  std::printf("sum of %zu values: iterator %.1f, parallel_reduce %.1f "
+              "ns/key (%lld %lld)\n",
+              numbers.size(), serial, reduced, serial_sum, parallel_sum);
+
+  // what a reader pays for a consistent view of a set a writer changes
+  s21::set<int> tree(numbers.begin(), numbers.end());
+  s21::persistent_set<int> persistent(numbers.begin(), numbers.end());
+  s21::set<int> tree_view;
+  s21::persistent_set<int> persistent_view;
+  double copy{NanosecondsPer(1, [&] { tree_view = tree; })};
+  double snapshot{
+      NanosecondsPer(1, [&] { persistent_view = persistent.snapshot(); })};
+  std::printf("\nview of %zu keys: set copy %.0f ns, persistent snapshot "
+              "%.0f ns (%zu %zu)\n",
+              numbers.size(), copy, snapshot, tree_view.size(),
+              persistent_view.size());
+
+  // a small set against a large one: a lookup and an insert per key, or
+  // cutting the large tree at the keys of the small one
+  s21::set<int> few_keys(numbers.begin(), numbers.begin() + 1000);
+  s21::set<int> looked_up;
+  s21::set<int> joined(few_keys);
+  double naive{NanosecondsPer(1000, [&] {
+    for (auto it = few_keys.begin(); it != few_keys.end(); ++it)
+      if (tree.contains(*it)) looked_up.insert(*it);
+  })};
+  double split{NanosecondsPer(1000, [&] { joined.intersect(tree); })};
+  std::printf("intersection of 1000 and %zu keys: contains + insert %.1f, "
+              "split/join %.1f ns/key (%zu %zu)\n",
+              numbers.size(), naive, split, looked_up.size(), joined.size());
+
+  return clean ? 0 : 1;
+}
@@ -0,0 +1,719 @@
+#ifndef SRC_IMPLEMENTATIONS_BTREE_H
+#define SRC_IMPLEMENTATIONS_BTREE_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <utility>
+
+#include "simd_search.h"
+#include "tree.h"
+
+namespace s21 {
+// about four cache lines of values per node, at least three keys
+template <class Value>
+constexpr size_t BtreeDefaultFanOut() {
+  size_t fan_out{256 / sizeof(Value)};
+  return fan_out < 4 ? 4 : fan_out & ~size_t{1};
+}
+
+// A B-tree keeping up to FanOut - 1 values in each node, so that a lookup
+// touches one node per level instead of one value. Inserts split full nodes
+// on the way down, erases refill short nodes on the way up; both may move
+// values between nodes and so invalidate iterators. The lookups take any
+// key type the comparator accepts; the containers offer the other types
+// only when Compare declares is_transparent.
+template <class Key = int, class Value = Key,
+          class KeyOfValue = KeyIdentity<Key>,
+          class Compare = std::less<Key>,
+          size_t FanOut = BtreeDefaultFanOut<Value>()>
+class BTree {
+  static_assert(FanOut >= 4 && FanOut % 2 == 0,
+                "s21::BTree: the fan-out must be even and at least 4");
+
+  static constexpr size_t kMaxKeys{FanOut - 1};
+  static constexpr size_t kMinKeys{FanOut / 2 - 1};
+
+  // leaves have no child pointers, so they hold values only
+  struct node {
+    node* parent;
+    unsigned position;
+    unsigned count;
+    bool leaf;
+    alignas(Value) unsigned char storage[kMaxKeys * sizeof(Value)];
+
+    Value* slot(size_t index) {
+      return reinterpret_cast<Value*>(storage) + index;
+    }
+    const Value* slot(size_t index) const {
+      return reinterpret_cast<const Value*>(storage) + index;
+    }
+  };
+
+  struct internal_node : node {
+    node* children[FanOut];
+  };
+
+  // where a key goes: the slot of an equal key when found, else the slot
+  // of a leaf with room; a null holder stands for an empty tree
+  struct insert_pos {
+    node* holder;
+    size_t index;
+    bool found;
+  };
+
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+  using key_compare = Compare;
+
+  BTree() : BTree(Compare()) {}
+
+  explicit BTree(const Compare& compare)
+      : root_{nullptr},
+        leftmost_{nullptr},
+        rightmost_{nullptr},
+        size_{0},
+        compare_{compare} {}
+
+  BTree(std::initializer_list<value_type> const& init, bool duplicate)
+      : BTree(init.begin(), init.end(), duplicate) {}
+
+  template <class Iterator>
+  BTree(Iterator first, Iterator last, bool duplicate) : BTree() {
+    for (; first != last; ++first) insert(*first, duplicate);
+  }
+
+  BTree(const BTree& other) : BTree(other.compare_) { *this = other; }
+
+  BTree(BTree&& other) noexcept : BTree() { swap(other); }
+
+  ~BTree() { DestroySubtree(root_); }
+
+  // copies node by node, keeping the shape of other
+  BTree& operator=(const BTree& other) {
+    if (this == &other) return *this;
+
+    clear();
+    compare_ = other.compare_;
+    if (other.root_) root_ = CloneSubtree(other.root_, nullptr);
+    size_ = other.size_;
+    UpdateEdges();
+    return *this;
+  }
+
+  BTree& operator=(BTree&& other) noexcept {
+    if (this == &other) return *this;
+
+    swap(other);
+    other.clear();
+    return *this;
+  }
+
+  // a value in a node; end() sits one past the last value of the
+  // rightmost leaf
+  class BTreeIterator {
+   public:
+    using value_type = Value;
+    using reference = value_type&;
+    using pointer = value_type*;
+    using iterator = BTreeIterator;
+
+    BTreeIterator(node* at, size_t index) : current(at), position(index) {}
+
+    reference operator*() const { return *current->slot(position); }
+
+    pointer operator->() const { return current->slot(position); }
+
+    iterator& operator++() {
+      if (!current->leaf) {
+        current = Child(current, position + 1);
+        while (!current->leaf) current = Child(current, 0);
+        position = 0;
+      } else if (++position == current->count) {
+        // climb to the first ancestor with a value to the right, or stay
+        // at the end of the rightmost leaf
+        node* ancestor{current};
+        size_t index{position};
+        while (index == ancestor->count && ancestor->parent) {
+          index = ancestor->position;
+          ancestor = ancestor->parent;
+        }
+        if (index < ancestor->count) {
+          current = ancestor;
+          position = index;
+        }
+      }
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator temp = *this;
+      ++(*this);
+      return temp;
+    }
+
+    iterator& operator--() {
+      if (!current->leaf) {
+        current = Child(current, position);
+        while (!current->leaf) current = Child(current, current->count);
+        position = current->count - 1;
+      } else if (position > 0) {
+        --position;
+      } else {
+        node* ancestor{current};
+        size_t index{0};
+        while (index == 0 && ancestor->parent) {
+          index = ancestor->position;
+          ancestor = ancestor->parent;
+        }
+        if (index > 0) {
+          current = ancestor;
+          position = index - 1;
+        }
+      }
+      return *this;
+    }
+
+    iterator operator--(int) {
+      iterator temp = *this;
+      --(*this);
+      return temp;
+    }
+
+    bool operator==(const iterator& other) const {
+      return current == other.current && position == other.position;
+    }
+
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    node* current;
+    size_t position;
+    friend class BTree;
+  };  // class BTreeIterator
+
+  class ConstBTreeIterator : public BTreeIterator {
+   public:
+    ConstBTreeIterator(BTreeIterator other) : BTreeIterator(other) {}
+    const_reference operator*() const { return BTreeIterator::operator*(); }
+  };
+
+  using iterator = BTreeIterator;
+  using const_iterator = ConstBTreeIterator;
+
+  iterator begin() const { return iterator(leftmost_, 0); }
+
+  iterator end() const {
+    return iterator(rightmost_, rightmost_ ? rightmost_->count : 0);
+  }
+
+  bool empty() const { return size_ == 0; }
+
+  size_type size() const { return size_; }
+
+  size_type max_size() const {
+    return std::numeric_limits<std::ptrdiff_t>::max() / sizeof(value_type);
+  }
+
+  void clear() {
+    DestroySubtree(root_);
+    root_ = leftmost_ = rightmost_ = nullptr;
+    size_ = 0;
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value, bool duplicate) {
+    return InsertValue(value_type(value), duplicate);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(bool duplicate, Args&&... args) {
+    return InsertValue(value_type(std::forward<Args>(args)...), duplicate);
+  }
+
+  // builds the value only when the key is not there yet
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    insert_pos pos{FindInsertPos(key, false)};
+    if (pos.found)
+      return std::pair<iterator, bool>(iterator(pos.holder, pos.index), false);
+
+    return std::pair<iterator, bool>(
+        LinkValue(pos, value_type(std::forward<Args>(args)...)), true);
+  }
+
+  void erase(iterator pos) { EraseSlot(pos.current, pos.position); }
+
+  void swap(BTree& other) {
+    std::swap(root_, other.root_);
+    std::swap(leftmost_, other.leftmost_);
+    std::swap(rightmost_, other.rightmost_);
+    std::swap(size_, other.size_);
+    std::swap(compare_, other.compare_);
+  }
+
+  // moves the values of other whose keys fit into this tree; values live
+  // inside their nodes, so they are moved one by one
+  void merge(BTree& other, bool duplicate) {
+    if (this == &other || other.empty()) return;
+
+    BTree kept(other.compare_);
+    for (iterator it{other.begin()}; it != other.end(); ++it) {
+      insert_pos pos{FindInsertPos(KeyOf(*it), duplicate)};
+      if (pos.found) {
+        kept.InsertValue(std::move(*it), true);
+      } else {
+        LinkValue(pos, std::move(*it));
+      }
+    }
+    other.swap(kept);
+  }
+
+  template <class K>
+  iterator find(const K& key) const {
+    iterator bound{lower_bound(key)};
+    if (bound == end() || Less(key, KeyOf(*bound))) return end();
+    return bound;
+  }
+
+  template <class K>
+  bool contains(const K& key) const { return find(key) != end(); }
+
+  // the first value not less than key
+  template <class K>
+  iterator lower_bound(const K& key) const {
+    iterator bound{end()};
+    for (node* current{root_}; current;) {
+      size_t index{LowerIndex(current, key)};
+      if (index < current->count) bound = iterator(current, index);
+      if (current->leaf) break;
+      current = Child(current, index);
+    }
+    return bound;
+  }
+
+  // the first value greater than key
+  template <class K>
+  iterator upper_bound(const K& key) const {
+    iterator bound{end()};
+    for (node* current{root_}; current;) {
+      size_t index{UpperIndex(current, key)};
+      if (index < current->count) bound = iterator(current, index);
+      if (current->leaf) break;
+      current = Child(current, index);
+    }
+    return bound;
+  }
+
+  template <class K>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  template <class K>
+  size_type count(const K& key) const {
+    size_type count{0};
+    for (iterator it{lower_bound(key)};
+         it != end() && !Less(key, KeyOf(*it)); ++it)
+      count++;
+    return count;
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+  // checks the B-tree invariants: every leaf at the same depth, between
+  // kMinKeys and kMaxKeys values in every node but the root, ordered values
+  // and consistent parent links
+  bool CheckBalance() const {
+    if (!root_) return size_ == 0 && !leftmost_ && !rightmost_;
+    if (root_->parent || !root_->count) return false;
+
+    size_t leaf_depth{0};
+    size_t values{0};
+    if (!CheckNode(root_, 0, leaf_depth, values)) return false;
+
+    const node* leftmost{root_};
+    while (!leftmost->leaf) leftmost = Child(leftmost, 0);
+    const node* rightmost{root_};
+    while (!rightmost->leaf) rightmost = Child(rightmost, rightmost->count);
+    return values == size_ && leftmost == leftmost_ && rightmost == rightmost_;
+  }
+
+ private:
+  node* root_;
+  node* leftmost_;
+  node* rightmost_;
+  size_type size_;
+  Compare compare_;
+
+  static node*& Child(node* parent, size_t index) {
+    return static_cast<internal_node*>(parent)->children[index];
+  }
+
+  static const node* Child(const node* parent, size_t index) {
+    return static_cast<const internal_node*>(parent)->children[index];
+  }
+
+  static const key_type& KeyOf(const value_type& value) {
+    return KeyOfValue()(value);
+  }
+
+  template <class A, class B>
+  bool Less(const A& a, const B& b) const {
+    return compare_(a, b);
+  }
+
+  // binary searches within one node; the range only ever shrinks by half
+  // and its base moves by a conditional add, which compiles to a select
+  // instead of an unpredictable branch. Arithmetic keys are counted with
+  // vector compares instead, see simd_search.h.
+  template <class K>
+  size_t LowerIndex(const node* current, const K& key) const {
+    const Value* values{current->slot(0)};
+    if constexpr (SimdSearchable<Key, Value, KeyOfValue, Compare, K>())
+      return SimdLowerIndex(values, current->count, key);
+    size_t base{0};
+    size_t length{current->count};
+    if (!length) return 0;
+    while (length > 1) {
+      size_t half{length / 2};
+      base += Less(KeyOf(values[base + half - 1]), key) ? half : 0;
+      length -= half;
+    }
+    return base + Less(KeyOf(values[base]), key);
+  }
+
+  template <class K>
+  size_t UpperIndex(const node* current, const K& key) const {
+    const Value* values{current->slot(0)};
+    if constexpr (SimdSearchable<Key, Value, KeyOfValue, Compare, K>())
+      return SimdUpperIndex(values, current->count, key);
+    size_t base{0};
+    size_t length{current->count};
+    if (!length) return 0;
+    while (length > 1) {
+      size_t half{length / 2};
+      base += Less(key, KeyOf(values[base + half - 1])) ? 0 : half;
+      length -= half;
+    }
+    return base + !Less(key, KeyOf(values[base]));
+  }
+
+  static node* NewNode(bool leaf) {
+    node* created{leaf ? new node : new internal_node()};
+    created->parent = nullptr;
+    created->position = 0;
+    created->count = 0;
+    created->leaf = leaf;
+    return created;
+  }
+
+  static void DeleteNode(node* current) {
+    if (current->leaf) {
+      delete current;
+    } else {
+      delete static_cast<internal_node*>(current);
+    }
+  }
+
+  // children of a node under construction may still be null
+  static void DestroySubtree(node* current) {
+    if (!current) return;
+
+    if (!current->leaf) {
+      for (size_t i = 0; i <= current->count; ++i)
+        DestroySubtree(Child(current, i));
+    }
+    for (size_t i = 0; i < current->count; ++i) current->slot(i)->~Value();
+    DeleteNode(current);
+  }
+
+  static node* CloneSubtree(const node* source, node* parent) {
+    node* copy{NewNode(source->leaf)};
+    copy->parent = parent;
+    copy->position = source->position;
+    try {
+      for (size_t i = 0; i < source->count; ++i) {
+        new (copy->slot(i)) Value(*source->slot(i));
+        copy->count++;
+      }
+      if (!source->leaf) {
+        for (size_t i = 0; i <= source->count; ++i)
+          Child(copy, i) = CloneSubtree(Child(source, i), copy);
+      }
+    } catch (...) {
+      DestroySubtree(copy);
+      throw;
+    }
+    return copy;
+  }
+
+  void UpdateEdges() {
+    leftmost_ = rightmost_ = root_;
+    if (!root_) return;
+
+    while (!leftmost_->leaf) leftmost_ = Child(leftmost_, 0);
+    while (!rightmost_->leaf) rightmost_ = Child(rightmost_, rightmost_->count);
+  }
+
+  // moves a value into an empty slot and leaves its old slot empty
+  static void MoveSlot(node* to, size_t to_index, node* from,
+                       size_t from_index) {
+    new (to->slot(to_index)) Value(std::move(*from->slot(from_index)));
+    from->slot(from_index)->~Value();
+  }
+
+  // opens an empty slot at index; the count is left to the caller
+  static void ShiftRight(node* current, size_t index) {
+    for (size_t i = current->count; i > index; --i)
+      MoveSlot(current, i, current, i - 1);
+  }
+
+  // closes the empty slot at index; the count is left to the caller
+  static void ShiftLeft(node* current, size_t index) {
+    for (size_t i = index + 1; i < current->count; ++i)
+      MoveSlot(current, i - 1, current, i);
+  }
+
+  static void SetChild(node* parent, size_t index, node* child) {
+    Child(parent, index) = child;
+    child->parent = parent;
+    child->position = index;
+  }
+
+  // splits the full child at index around its median, which moves up
+  static void SplitChild(node* parent, size_t index) {
+    node* full{Child(parent, index)};
+    node* sibling{NewNode(full->leaf)};
+    const size_t half{FanOut / 2};
+
+    for (size_t i = 0; i + 1 < half; ++i) MoveSlot(sibling, i, full, i + half);
+    if (!full->leaf) {
+      for (size_t i = 0; i < half; ++i)
+        SetChild(sibling, i, Child(full, i + half));
+    }
+    sibling->count = half - 1;
+
+    ShiftRight(parent, index);
+    for (size_t i = parent->count + 1; i > index + 1; --i)
+      SetChild(parent, i, Child(parent, i - 1));
+    MoveSlot(parent, index, full, half - 1);
+    SetChild(parent, index + 1, sibling);
+    parent->count++;
+    full->count = half - 1;
+  }
+
+  std::pair<iterator, bool> InsertValue(value_type&& value, bool duplicate) {
+    insert_pos pos{FindInsertPos(KeyOf(value), duplicate)};
+    if (pos.found)
+      return std::pair<iterator, bool>(iterator(pos.holder, pos.index), false);
+
+    return std::pair<iterator, bool>(LinkValue(pos, std::move(value)), true);
+  }
+
+  // one descent from the root, splitting every full node on the way so that
+  // the leaf always has room; equal keys go after the present ones. Without
+  // duplicates an equal key is the one just left of the descent, so it is
+  // found on the way down; the splits made until then are harmless.
+  template <class K>
+  insert_pos FindInsertPos(const K& key, bool duplicate) {
+    if (!root_) return insert_pos{nullptr, 0, false};
+
+    bool split{false};
+    if (root_->count == kMaxKeys) {
+      node* old_root{root_};
+      root_ = NewNode(false);
+      SetChild(root_, 0, old_root);
+      SplitChild(root_, 0);
+      split = true;
+    }
+
+    // the splits made on the way down may have moved the first or last leaf
+    auto at = [this, &split](node* holder, size_t index, bool found) {
+      if (split) UpdateEdges();
+      return insert_pos{holder, index, found};
+    };
+
+    node* current{root_};
+    size_t index{UpperIndex(current, key)};
+    while (true) {
+      if (!duplicate && index > 0 &&
+          !Less(KeyOf(*current->slot(index - 1)), key))
+        return at(current, index - 1, true);
+      if (current->leaf) break;
+
+      if (Child(current, index)->count == kMaxKeys) {
+        SplitChild(current, index);
+        split = true;
+        if (!Less(key, KeyOf(*current->slot(index)))) {
+          if (!duplicate && !Less(KeyOf(*current->slot(index)), key))
+            return at(current, index, true);
+          index++;
+        }
+      }
+      current = Child(current, index);
+      index = UpperIndex(current, key);
+    }
+    return at(current, index, false);
+  }
+
+  // moves value into the free slot FindInsertPos found
+  iterator LinkValue(insert_pos pos, value_type&& value) {
+    if (!pos.holder)
+      pos.holder = root_ = leftmost_ = rightmost_ = NewNode(true);
+
+    ShiftRight(pos.holder, pos.index);
+    new (pos.holder->slot(pos.index)) Value(std::move(value));
+    pos.holder->count++;
+    size_++;
+    return iterator(pos.holder, pos.index);
+  }
+
+  // a value of an inner node trades places with its in-order predecessor,
+  // so the slot that goes away is always in a leaf
+  void EraseSlot(node* current, size_t index) {
+    if (!current->leaf) {
+      node* leaf{Child(current, index)};
+      while (!leaf->leaf) leaf = Child(leaf, leaf->count);
+      current->slot(index)->~Value();
+      MoveSlot(current, index, leaf, leaf->count - 1);
+      current = leaf;
+      index = leaf->count - 1;
+    } else {
+      current->slot(index)->~Value();
+    }
+
+    ShiftLeft(current, index);
+    current->count--;
+    size_--;
+    if (Rebalance(current)) UpdateEdges();
+  }
+
+  // refills a short node from a sibling, or merges it with one and carries
+  // on with the parent that lost a value; tells whether nodes went away
+  bool Rebalance(node* current) {
+    bool merged{false};
+    while (current != root_ && current->count < kMinKeys) {
+      node* parent{current->parent};
+      size_t position{current->position};
+      node* left{position > 0 ? Child(parent, position - 1) : nullptr};
+      node* right{position < parent->count ? Child(parent, position + 1)
+                                           : nullptr};
+      if (left && left->count > kMinKeys) {
+        BorrowFromLeft(parent, position);
+        return merged;
+      }
+      if (right && right->count > kMinKeys) {
+        BorrowFromRight(parent, position);
+        return merged;
+      }
+      MergeChildren(parent, left ? position - 1 : position);
+      merged = true;
+      current = parent;
+    }
+
+    if (root_->count == 0) {
+      node* old_root{root_};
+      root_ = root_->leaf ? nullptr : Child(root_, 0);
+      if (root_) {
+        root_->parent = nullptr;
+        root_->position = 0;
+      }
+      DeleteNode(old_root);
+      merged = true;
+    }
+    return merged;
+  }
+
+  static void BorrowFromLeft(node* parent, size_t position) {
+    node* current{Child(parent, position)};
+    node* left{Child(parent, position - 1)};
+
+    ShiftRight(current, 0);
+    MoveSlot(current, 0, parent, position - 1);
+    MoveSlot(parent, position - 1, left, left->count - 1);
+    if (!current->leaf) {
+      for (size_t i = current->count + 1; i > 0; --i)
+        SetChild(current, i, Child(current, i - 1));
+      SetChild(current, 0, Child(left, left->count));
+    }
+    current->count++;
+    left->count--;
+  }
+
+  static void BorrowFromRight(node* parent, size_t position) {
+    node* current{Child(parent, position)};
+    node* right{Child(parent, position + 1)};
+
+    MoveSlot(current, current->count, parent, position);
+    MoveSlot(parent, position, right, 0);
+    ShiftLeft(right, 0);
+    if (!current->leaf) {
+      SetChild(current, current->count + 1, Child(right, 0));
+      for (size_t i = 0; i < right->count; ++i)
+        SetChild(right, i, Child(right, i + 1));
+    }
+    current->count++;
+    right->count--;
+  }
+
+  // joins the children at index and index + 1 around their separator
+  static void MergeChildren(node* parent, size_t index) {
+    node* left{Child(parent, index)};
+    node* right{Child(parent, index + 1)};
+
+    MoveSlot(left, left->count, parent, index);
+    for (size_t i = 0; i < right->count; ++i)
+      MoveSlot(left, left->count + 1 + i, right, i);
+    if (!left->leaf) {
+      for (size_t i = 0; i <= right->count; ++i)
+        SetChild(left, left->count + 1 + i, Child(right, i));
+    }
+    left->count += right->count + 1;
+
+    ShiftLeft(parent, index);
+    for (size_t i = index + 1; i < parent->count; ++i)
+      SetChild(parent, i, Child(parent, i + 1));
+    parent->count--;
+    right->count = 0;
+    DeleteNode(right);
+  }
+
+  bool CheckNode(const node* current, size_t depth, size_t& leaf_depth,
+                 size_t& values) const {
+    if (current != root_ && current->count < kMinKeys) return false;
+    if (current->count > kMaxKeys) return false;
+    for (size_t i = 1; i < current->count; ++i) {
+      if (Less(KeyOf(*current->slot(i)), KeyOf(*current->slot(i - 1))))
+        return false;
+    }
+    values += current->count;
+
+    if (current->leaf) {
+      if (!leaf_depth) leaf_depth = depth + 1;
+      return leaf_depth == depth + 1;
+    }
+
+    for (size_t i = 0; i <= current->count; ++i) {
+      const node* child{Child(current, i)};
+      if (child->parent != current || child->position != i) return false;
+      // the separators bound the values of the children around them
+      if (i > 0 && Less(KeyOf(*child->slot(0)), KeyOf(*current->slot(i - 1))))
+        return false;
+      if (i < current->count &&
+          Less(KeyOf(*current->slot(i)),
+               KeyOf(*child->slot(child->count - 1))))
+        return false;
+      if (!CheckNode(child, depth + 1, leaf_depth, values)) return false;
+    }
+    return true;
+  }
+};  // class BTree
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_BTREE_H
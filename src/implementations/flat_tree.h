@@ -0,0 +1,313 @@
+#ifndef SRC_IMPLEMENTATIONS_FLAT_TREE_H
+#define SRC_IMPLEMENTATIONS_FLAT_TREE_H
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "s_vector.h"
+#include "simd_search.h"
+#include "tree.h"
+
+namespace s21 {
+// Sorted values in one s21::vector: lookups are binary searches over
+// contiguous memory and there is no per-value overhead, but a single insert
+// or erase shifts the tail. Bulk loads go through insert_range, which sorts
+// the new values once and merges them in. Like the vector, values must be
+// default constructible; any insert or erase invalidates iterators. The
+// lookups take any key type the comparator accepts; the containers offer
+// the other types only when Compare declares is_transparent.
+template <class Key = int, class Value = Key,
+          class KeyOfValue = KeyIdentity<Key>,
+          class Compare = std::less<Key>>
+class FlatTree {
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+  using key_compare = Compare;
+  using iterator = value_type*;
+  using const_iterator = const value_type*;
+
+  FlatTree() : FlatTree(Compare()) {}
+
+  explicit FlatTree(const Compare& compare) : values_(), compare_{compare} {}
+
+  FlatTree(std::initializer_list<value_type> const& init, bool duplicate)
+      : FlatTree(init.begin(), init.end(), duplicate) {}
+
+  template <class Iterator>
+  FlatTree(Iterator first, Iterator last, bool duplicate) : FlatTree() {
+    insert_range(first, last, duplicate);
+  }
+
+  FlatTree(const FlatTree& other)
+      : values_(other.values_), compare_{other.compare_} {}
+
+  FlatTree(FlatTree&& other) noexcept : FlatTree() { swap(other); }
+
+  FlatTree& operator=(const FlatTree& other) {
+    if (this == &other) return *this;
+
+    s21::vector<value_type> values(other.values_);
+    values_.swap(values);
+    compare_ = other.compare_;
+    return *this;
+  }
+
+  FlatTree& operator=(FlatTree&& other) noexcept {
+    if (this == &other) return *this;
+
+    swap(other);
+    other.clear();
+    return *this;
+  }
+
+  iterator begin() const { return const_cast<iterator>(values_.begin()); }
+
+  iterator end() const { return const_cast<iterator>(values_.end()); }
+
+  bool empty() const { return values_.empty(); }
+
+  size_type size() const { return values_.size(); }
+
+  size_type max_size() const {
+    return std::numeric_limits<std::ptrdiff_t>::max() / sizeof(value_type);
+  }
+
+  void reserve(size_type count) {
+    if (count > values_.capacity()) values_.reserve(count);
+  }
+
+  size_type capacity() { return values_.capacity(); }
+
+  void shrink_to_fit() { values_.shrink_to_fit(); }
+
+  void clear() {
+    s21::vector<value_type> values;
+    values_.swap(values);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value, bool duplicate) {
+    std::pair<iterator, bool> pos{FindInsertPos(KeyOf(value), duplicate)};
+    if (!pos.second) return pos;
+
+    return std::pair<iterator, bool>(InsertAt(pos.first, value), true);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(bool duplicate, Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    std::pair<iterator, bool> pos{FindInsertPos(KeyOf(value), duplicate)};
+    if (!pos.second) return pos;
+
+    return std::pair<iterator, bool>(InsertAt(pos.first, std::move(value)),
+                                     true);
+  }
+
+  // builds the value only when the key is not there yet
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    std::pair<iterator, bool> pos{FindInsertPos(key, false)};
+    if (!pos.second) return pos;
+
+    return std::pair<iterator, bool>(
+        InsertAt(pos.first, value_type(std::forward<Args>(args)...)), true);
+  }
+
+  // a right hint saves the binary search; the shift remains
+  std::pair<iterator, bool> insert(iterator hint, const value_type& value,
+                                   bool duplicate) {
+    const key_type& key{KeyOf(value)};
+    bool after_previous{hint == begin() ||
+                        (duplicate ? !Less(key, KeyOf(*(hint - 1)))
+                                   : Less(KeyOf(*(hint - 1)), key))};
+    bool before_next{hint == end() || (duplicate ? !Less(KeyOf(*hint), key)
+                                                 : Less(key, KeyOf(*hint)))};
+    if (after_previous && before_next)
+      return std::pair<iterator, bool>(InsertAt(hint, value), true);
+
+    return insert(value, duplicate);
+  }
+
+  // appends the range, sorts the new tail and merges it with the old values
+  // in one pass: O(n + k log k) instead of k shifts. Equal keys keep their
+  // order, present values first; without duplicates only the first of them
+  // stays.
+  template <class Iterator>
+  void insert_range(Iterator first, Iterator last, bool duplicate) {
+    size_type old_size{size()};
+    for (; first != last; ++first) values_.push_back(*first);
+    if (size() == old_size) return;
+
+    auto key_less = [this](const value_type& a, const value_type& b) {
+      return Less(KeyOf(a), KeyOf(b));
+    };
+    iterator middle{begin() + old_size};
+    std::stable_sort(middle, end(), key_less);
+    std::inplace_merge(begin(), middle, end(), key_less);
+    if (!duplicate) {
+      iterator unique_end{std::unique(
+          begin(), end(), [this](const value_type& a, const value_type& b) {
+            return !Less(KeyOf(a), KeyOf(b));
+          })};
+      while (end() != unique_end) values_.pop_back();
+    }
+  }
+
+  // replaces the contents with a sorted range; unsorted input throws
+  template <class Iterator>
+  void build_from_sorted(Iterator first, Iterator last, bool duplicate) {
+    FlatTree values(compare_);
+    for (; first != last; ++first) {
+      const value_type& value = *first;
+      if (!values.empty()) {
+        const key_type& back{KeyOf(*(values.end() - 1))};
+        if (Less(KeyOf(value), back))
+          throw std::invalid_argument("s21::FlatTree: range is not sorted");
+        if (!duplicate && !Less(back, KeyOf(value))) continue;
+      }
+      values.values_.push_back(value);
+    }
+    swap(values);
+  }
+
+  void erase(iterator pos) { values_.erase(pos); }
+
+  void swap(FlatTree& other) {
+    values_.swap(other.values_);
+    std::swap(compare_, other.compare_);
+  }
+
+  // one merging pass over both arrays that moves the values out of them;
+  // values whose keys are already here stay in other
+  void merge(FlatTree& other, bool duplicate) {
+    if (this == &other || other.empty()) return;
+
+    s21::vector<value_type> merged;
+    s21::vector<value_type> kept;
+    size_type count{size() + other.size()};
+    if (count > merged.capacity()) merged.reserve(count);
+    iterator mine{begin()};
+    iterator theirs{other.begin()};
+    while (mine != end() || theirs != other.end()) {
+      if (theirs == other.end() ||
+          (mine != end() && !Less(KeyOf(*theirs), KeyOf(*mine)))) {
+        merged.push_back(std::move(*mine++));
+      } else if (!duplicate && !merged.empty() &&
+                 !Less(KeyOf(merged.back()), KeyOf(*theirs))) {
+        kept.push_back(std::move(*theirs++));
+      } else {
+        merged.push_back(std::move(*theirs++));
+      }
+    }
+    values_.swap(merged);
+    other.values_.swap(kept);
+  }
+
+  template <class K>
+  iterator find(const K& key) const {
+    iterator bound{lower_bound(key)};
+    if (bound == end() || Less(key, KeyOf(*bound))) return end();
+    return bound;
+  }
+
+  template <class K>
+  bool contains(const K& key) const { return find(key) != end(); }
+
+  // the halving step is a conditional move rather than a branch, so a
+  // lookup costs no mispredictions, only the cache misses of the probes.
+  // Arithmetic keys go to the vector kernels of simd_search.h instead.
+  template <class K>
+  iterator lower_bound(const K& key) const {
+    if constexpr (SimdSearchable<Key, Value, KeyOfValue, Compare, K>())
+      return begin() + SimdLowerIndex(begin(), size(), key);
+    iterator base{begin()};
+    size_type length{size()};
+    while (length > 1) {
+      size_type half{length / 2};
+      base = Less(KeyOf(base[half - 1]), key) ? base + half : base;
+      length -= half;
+    }
+    return base + (length == 1 && Less(KeyOf(*base), key));
+  }
+
+  template <class K>
+  iterator upper_bound(const K& key) const {
+    if constexpr (SimdSearchable<Key, Value, KeyOfValue, Compare, K>())
+      return begin() + SimdUpperIndex(begin(), size(), key);
+    iterator base{begin()};
+    size_type length{size()};
+    while (length > 1) {
+      size_type half{length / 2};
+      base = Less(key, KeyOf(base[half - 1])) ? base : base + half;
+      length -= half;
+    }
+    return base + (length == 1 && !Less(key, KeyOf(*base)));
+  }
+
+  template <class K>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  template <class K>
+  size_type count(const K& key) const {
+    return upper_bound(key) - lower_bound(key);
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+  // the flat layout has no shape to balance; this checks the order only
+  bool CheckBalance() const {
+    for (iterator it{begin()}; it != end() && it + 1 != end(); ++it) {
+      if (Less(KeyOf(*(it + 1)), KeyOf(*it))) return false;
+    }
+    return true;
+  }
+
+ private:
+  s21::vector<value_type> values_;
+  Compare compare_;
+
+  static const key_type& KeyOf(const value_type& value) {
+    return KeyOfValue()(value);
+  }
+
+  template <class A, class B>
+  bool Less(const A& a, const B& b) const {
+    return compare_(a, b);
+  }
+
+  // equal keys go after the present ones; when the key is taken the
+  // present value comes back with false
+  std::pair<iterator, bool> FindInsertPos(const key_type& key,
+                                          bool duplicate) const {
+    iterator pos{upper_bound(key)};
+    if (!duplicate && pos != begin() && !Less(KeyOf(*(pos - 1)), key))
+      return std::pair<iterator, bool>(pos - 1, false);
+    return std::pair<iterator, bool>(pos, true);
+  }
+
+  // appends and rotates the value into place, so the vector only ever
+  // grows at its end
+  iterator InsertAt(iterator pos, const value_type& value) {
+    return InsertAt(pos, value_type(value));
+  }
+
+  iterator InsertAt(iterator pos, value_type&& value) {
+    size_type index{static_cast<size_type>(pos - begin())};
+    values_.push_back(std::move(value));
+    std::rotate(begin() + index, end() - 1, end());
+    return begin() + index;
+  }
+};  // class FlatTree
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_FLAT_TREE_H
@@ -0,0 +1,268 @@
+#ifndef SRC_IMPLEMENTATIONS_FROZEN_TREE_H
+#define SRC_IMPLEMENTATIONS_FROZEN_TREE_H
+
+#include <functional>
+#include <utility>
+
+#include "s_vector.h"
+#include "tree.h"
+
+namespace s21 {
+// An immutable copy of a sorted sequence in Eytzinger order: the values sit
+// in one array as the breadth-first walk of a complete binary search tree,
+// the children of slot k being 2k and 2k + 1 (slot 0 is unused). The top
+// levels of every search share the first cache lines, a descent computes
+// its next slot instead of branching on the comparison, and the slots a
+// few levels below are prefetched while the current ones are compared.
+// Values must be default constructible.
+template <class Key = int, class Value = Key,
+          class KeyOfValue = KeyIdentity<Key>,
+          class Compare = std::less<Key>>
+class FrozenTree {
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+  using key_compare = Compare;
+
+  // walks the slots in key order; end is slot 0
+  class FrozenIterator {
+   public:
+    using value_type = Value;
+    using reference = const value_type&;
+    using pointer = const value_type*;
+    using iterator = FrozenIterator;
+
+    FrozenIterator(const value_type* values, size_type size, size_type slot)
+        : values_(values), size_(size), slot_(slot) {}
+
+    reference operator*() const { return values_[slot_]; }
+
+    pointer operator->() const { return values_ + slot_; }
+
+    // the leftmost slot of the right subtree, or else the first ancestor
+    // reached from a left child
+    iterator& operator++() {
+      if (2 * slot_ + 1 <= size_) {
+        slot_ = 2 * slot_ + 1;
+        while (2 * slot_ <= size_) slot_ *= 2;
+      } else {
+        slot_ = Climb(slot_);
+      }
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator temp = *this;
+      ++(*this);
+      return temp;
+    }
+
+    // mirrors operator++; stepping back from end reaches the last slot
+    iterator& operator--() {
+      if (slot_ == 0) {
+        slot_ = size_ ? 1 : 0;
+        while (slot_ && 2 * slot_ + 1 <= size_) slot_ = 2 * slot_ + 1;
+      } else if (2 * slot_ <= size_) {
+        slot_ *= 2;
+        while (2 * slot_ + 1 <= size_) slot_ = 2 * slot_ + 1;
+      } else {
+        while (slot_ && !(slot_ & 1)) slot_ >>= 1;
+        slot_ >>= 1;
+      }
+      return *this;
+    }
+
+    iterator operator--(int) {
+      iterator temp = *this;
+      --(*this);
+      return temp;
+    }
+
+    bool operator==(const iterator& other) const {
+      return values_ == other.values_ && slot_ == other.slot_;
+    }
+
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    const value_type* values_;
+    size_type size_;
+    size_type slot_;
+  };  // class FrozenIterator
+
+  using iterator = FrozenIterator;
+  using const_iterator = FrozenIterator;
+
+  FrozenTree() : FrozenTree(Compare()) {}
+
+  explicit FrozenTree(const Compare& compare)
+      : values_(), size_{0}, compare_{compare} {
+    values_.push_back(value_type());
+  }
+
+  // copies count values of a sorted sequence in O(n), one in-order pass
+  // that fills the slots in the order a walk of the implicit tree visits
+  // them
+  template <class Iterator>
+  FrozenTree(Iterator first, size_type count, const Compare& compare)
+      : FrozenTree(compare) {
+    for (size_type i = 0; i < count; ++i) values_.push_back(value_type());
+    size_ = count;
+    Fill(1, first);
+  }
+
+  FrozenTree(const FrozenTree& other) = default;
+
+  // the moved-from tree is left empty
+  FrozenTree(FrozenTree&& other)
+      : values_(std::move(other.values_)),
+        size_{other.size_},
+        compare_{other.compare_} {
+    other.size_ = 0;
+  }
+
+  FrozenTree& operator=(const FrozenTree& other) {
+    if (this == &other) return *this;
+
+    s21::vector<value_type> values(other.values_);
+    values_.swap(values);
+    size_ = other.size_;
+    compare_ = other.compare_;
+    return *this;
+  }
+
+  FrozenTree& operator=(FrozenTree&& other) {
+    if (this == &other) return *this;
+
+    values_ = std::move(other.values_);
+    size_ = other.size_;
+    compare_ = other.compare_;
+    other.size_ = 0;
+    return *this;
+  }
+
+  iterator begin() const {
+    size_type slot{size_ ? 1U : 0U};
+    while (2 * slot <= size_ && slot) slot *= 2;
+    return iterator(Values(), size_, slot);
+  }
+
+  iterator end() const { return iterator(Values(), size_, 0); }
+
+  bool empty() const { return size_ == 0; }
+
+  size_type size() const { return size_; }
+
+  iterator find(const key_type& key) const {
+    size_type slot{LowerSlot(key)};
+    if (slot && Less(key, KeyOf(Values()[slot]))) slot = 0;
+    return iterator(Values(), size_, slot);
+  }
+
+  bool contains(const key_type& key) const {
+    size_type slot{LowerSlot(key)};
+    return slot && !Less(key, KeyOf(Values()[slot]));
+  }
+
+  iterator lower_bound(const key_type& key) const {
+    return iterator(Values(), size_, LowerSlot(key));
+  }
+
+  iterator upper_bound(const key_type& key) const {
+    return iterator(Values(), size_, UpperSlot(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) const {
+    return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  // O(log n + count)
+  size_type count(const key_type& key) const {
+    size_type result{0};
+    for (iterator it{lower_bound(key)}, last{upper_bound(key)}; it != last;
+         ++it)
+      result++;
+    return result;
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+ private:
+  // a cache line of values; a prefetch of slot k * kLine covers the
+  // descendants of k that many levels down
+  static constexpr size_type kLine{
+      sizeof(value_type) >= 64 ? 1 : 64 / sizeof(value_type)};
+
+  s21::vector<value_type> values_;
+  size_type size_;
+  Compare compare_;
+
+  const value_type* Values() const { return values_.begin(); }
+
+  static const key_type& KeyOf(const value_type& value) {
+    return KeyOfValue()(value);
+  }
+
+  template <class A, class B>
+  bool Less(const A& a, const B& b) const {
+    return compare_(a, b);
+  }
+
+  static void Prefetch(const value_type* address) {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+  }
+
+  // undoes the right turns at the bottom of a descent and the last left
+  // turn: the slot where the descent went left for the last time, or 0
+  static size_type Climb(size_type slot) {
+#if defined(__GNUC__)
+    return slot >> (__builtin_ctzll(~static_cast<unsigned long long>(slot)) +
+                    1);
+#else
+    while (slot & 1) slot >>= 1;
+    return slot >> 1;
+#endif
+  }
+
+  // the first slot not less than key, or 0
+  size_type LowerSlot(const key_type& key) const {
+    const value_type* values{Values()};
+    size_type slot{1};
+    while (slot <= size_) {
+      Prefetch(values + slot * kLine);
+      slot = 2 * slot + Less(KeyOf(values[slot]), key);
+    }
+    return Climb(slot);
+  }
+
+  // the first slot greater than key, or 0
+  size_type UpperSlot(const key_type& key) const {
+    const value_type* values{Values()};
+    size_type slot{1};
+    while (slot <= size_) {
+      Prefetch(values + slot * kLine);
+      slot = 2 * slot + !Less(key, KeyOf(values[slot]));
+    }
+    return Climb(slot);
+  }
+
+  template <class Iterator>
+  void Fill(size_type slot, Iterator& source) {
+    if (slot > size_) return;
+
+    Fill(2 * slot, source);
+    values_.begin()[slot] = *source;
+    ++source;
+    Fill(2 * slot + 1, source);
+  }
+};  // class FrozenTree
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_FROZEN_TREE_H
@@ -0,0 +1,476 @@
+#ifndef SRC_IMPLEMENTATIONS_HASH_TABLE_H
+#define SRC_IMPLEMENTATIONS_HASH_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "tree.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace s21 {
+// An open-addressing hash table in the style of the Swiss tables: the
+// values live in one array of slots and a parallel array of control bytes
+// says which slots are empty, deleted, or full. A full slot's control byte
+// holds 7 bits of the key's hash, so a probe loads a group of 16 control
+// bytes, compares all of them with those bits in one SSE2 instruction and
+// looks only at the slots that match; the probe stops at the first group
+// with an empty slot. Capacities are powers of two. Erased slots become
+// tombstones until the next rehash. Once values and tombstones fill 7/8 of
+// the slots the table is rehashed: at twice the capacity when the values
+// alone would pass 13/16, otherwise at the same capacity, which only drops
+// the tombstones. Any rehash invalidates iterators.
+template <class Key = int, class Value = Key,
+          class KeyOfValue = KeyIdentity<Key>, class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>>
+class HashTable {
+  using ctrl_t = int8_t;
+
+  static constexpr ctrl_t kEmpty{-128};
+  static constexpr ctrl_t kDeleted{-2};
+  static constexpr size_t kGroupWidth{16};
+
+  // the control bytes of one probe step, as a bitmask per question
+  class Group {
+   public:
+    explicit Group(const ctrl_t* ctrl) {
+#if defined(__SSE2__)
+      ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+      std::memcpy(ctrl_, ctrl, kGroupWidth);
+#endif
+    }
+
+    uint32_t Match(ctrl_t hash) const {
+#if defined(__SSE2__)
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(hash)));
+#else
+      uint32_t mask{0};
+      for (size_t i = 0; i < kGroupWidth; ++i)
+        mask |= static_cast<uint32_t>(ctrl_[i] == hash) << i;
+      return mask;
+#endif
+    }
+
+    uint32_t MatchEmpty() const { return Match(kEmpty); }
+
+    // empty and deleted are the only negative control bytes
+    uint32_t MatchFree() const {
+#if defined(__SSE2__)
+      return _mm_movemask_epi8(ctrl_);
+#else
+      uint32_t mask{0};
+      for (size_t i = 0; i < kGroupWidth; ++i)
+        mask |= static_cast<uint32_t>(ctrl_[i] < 0) << i;
+      return mask;
+#endif
+    }
+
+   private:
+#if defined(__SSE2__)
+    __m128i ctrl_;
+#else
+    ctrl_t ctrl_[kGroupWidth];
+#endif
+  };  // class Group
+
+  static size_t LowestBit(uint32_t mask) {
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    size_t index{0};
+    while (!(mask & 1)) {
+      mask >>= 1;
+      ++index;
+    }
+    return index;
+#endif
+  }
+
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+
+  // walks the full slots in slot order
+  class HashIterator {
+   public:
+    using value_type = Value;
+    using reference = value_type&;
+    using pointer = value_type*;
+    using iterator = HashIterator;
+
+    HashIterator(const ctrl_t* ctrl, value_type* slot, const ctrl_t* last)
+        : ctrl_(ctrl), slot_(slot), last_(last) {
+      SkipFree();
+    }
+
+    reference operator*() const { return *slot_; }
+
+    pointer operator->() const { return slot_; }
+
+    iterator& operator++() {
+      ++ctrl_;
+      ++slot_;
+      SkipFree();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator temp = *this;
+      ++(*this);
+      return temp;
+    }
+
+    bool operator==(const iterator& other) const {
+      return ctrl_ == other.ctrl_;
+    }
+
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    const ctrl_t* ctrl_;
+    value_type* slot_;
+    const ctrl_t* last_;
+    friend class HashTable;
+
+    void SkipFree() {
+      while (ctrl_ != last_ && *ctrl_ < 0) {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+  };  // class HashIterator
+
+  using iterator = HashIterator;
+  using const_iterator = HashIterator;
+
+  HashTable() : HashTable(Hash(), KeyEqual()) {}
+
+  HashTable(const Hash& hash, const KeyEqual& equal)
+      : ctrl_{nullptr},
+        slots_{nullptr},
+        capacity_{0},
+        size_{0},
+        growth_left_{0},
+        hash_{hash},
+        equal_{equal} {}
+
+  HashTable(std::initializer_list<value_type> const& init)
+      : HashTable(init.begin(), init.end()) {}
+
+  template <class Iterator>
+  HashTable(Iterator first, Iterator last) : HashTable() {
+    for (; first != last; ++first) insert(*first);
+  }
+
+  HashTable(const HashTable& other) : HashTable(other.hash_, other.equal_) {
+    reserve(other.size_);
+    for (const value_type& value : other) InsertNew(value);
+  }
+
+  HashTable(HashTable&& other) noexcept : HashTable() { swap(other); }
+
+  ~HashTable() { Release(); }
+
+  HashTable& operator=(const HashTable& other) {
+    if (this == &other) return *this;
+
+    HashTable copy(other);
+    swap(copy);
+    return *this;
+  }
+
+  HashTable& operator=(HashTable&& other) noexcept {
+    if (this == &other) return *this;
+
+    swap(other);
+    other.clear();
+    return *this;
+  }
+
+  iterator begin() const {
+    return iterator(ctrl_, slots_, ctrl_ + capacity_);
+  }
+
+  iterator end() const {
+    return iterator(ctrl_ + capacity_, slots_ + capacity_, ctrl_ + capacity_);
+  }
+
+  bool empty() const { return size_ == 0; }
+
+  size_type size() const { return size_; }
+
+  size_type max_size() const {
+    return std::numeric_limits<std::ptrdiff_t>::max() /
+           (sizeof(value_type) + sizeof(ctrl_t));
+  }
+
+  size_type capacity() const { return capacity_; }
+
+  // makes room for count values without another rehash
+  void reserve(size_type count) {
+    size_type capacity{kGroupWidth};
+    while (MaxLoad(capacity) < count) capacity *= 2;
+    if (capacity > capacity_) Rehash(capacity);
+  }
+
+  void clear() {
+    Release();
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = size_ = growth_left_ = 0;
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(KeyOf(value), value);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return try_emplace(KeyOf(value), std::move(value));
+  }
+
+  // builds the value from args only when the key is not there yet
+  template <class K, class... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    size_t hash{HashOf(key)};
+    size_t index{FindIndex(key, hash)};
+    if (index != capacity_) return std::pair<iterator, bool>(At(index), false);
+
+    index = PrepareInsert(hash);
+    new (slots_ + index) value_type(std::forward<Args>(args)...);
+    SetCtrl(index, H2(hash));
+    size_++;
+    return std::pair<iterator, bool>(At(index), true);
+  }
+
+  // leaves a tombstone, so that probes for other keys still pass the slot
+  void erase(iterator pos) {
+    size_t index{static_cast<size_t>(pos.ctrl_ - ctrl_)};
+    slots_[index].~value_type();
+    SetCtrl(index, kDeleted);
+    size_--;
+  }
+
+  void swap(HashTable& other) {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(hash_, other.hash_);
+    std::swap(equal_, other.equal_);
+  }
+
+  // moves the values of other whose keys are not here yet
+  void merge(HashTable& other) {
+    if (this == &other) return;
+
+    for (iterator it{other.begin()}; it != other.end(); ++it) {
+      if (try_emplace(KeyOf(*it), std::move(*it)).second) other.erase(it);
+    }
+  }
+
+  template <class K>
+  iterator find(const K& key) const {
+    return At(FindIndex(key, HashOf(key)));
+  }
+
+  template <class K>
+  bool contains(const K& key) const {
+    return FindIndex(key, HashOf(key)) != capacity_;
+  }
+
+  template <class K>
+  size_type count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  float load_factor() const {
+    return capacity_ ? static_cast<float>(size_) / capacity_ : 0.0f;
+  }
+
+  hasher hash_function() const { return hash_; }
+
+  key_equal key_eq() const { return equal_; }
+
+ private:
+  ctrl_t* ctrl_;
+  value_type* slots_;
+  size_t capacity_;
+  size_t size_;
+  // free slots that may still be taken before the load factor is reached;
+  // tombstones are not counted as free
+  size_t growth_left_;
+  Hash hash_;
+  KeyEqual equal_;
+
+  // the slots values and tombstones may fill before a rehash, 7/8
+  static size_t MaxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+  static const key_type& KeyOf(const value_type& value) {
+    return KeyOfValue()(value);
+  }
+
+  // std::hash of integers is the identity, so the bits are mixed by a
+  // multiplication before the table takes its slot and control bits
+  template <class K>
+  size_t HashOf(const K& key) const {
+    uint64_t hash{static_cast<uint64_t>(hash_(key))};
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product{static_cast<unsigned __int128>(hash) *
+                              0x9E3779B97F4A7C15ULL};
+    return static_cast<size_t>(static_cast<uint64_t>(product) ^
+                               static_cast<uint64_t>(product >> 64));
+#else
+    hash *= 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+#endif
+  }
+
+  static size_t H1(size_t hash) { return hash >> 7; }
+
+  static ctrl_t H2(size_t hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+
+  iterator At(size_t index) const {
+    return iterator(ctrl_ + index, slots_ + index, ctrl_ + capacity_);
+  }
+
+  // the first kGroupWidth control bytes are repeated after the last one,
+  // so a group starting near the end reads the start of the table
+  static void SetCtrl(ctrl_t* ctrl, size_t capacity, size_t index,
+                      ctrl_t value) {
+    ctrl[index] = value;
+    if (index < kGroupWidth) ctrl[capacity + index] = value;
+  }
+
+  void SetCtrl(size_t index, ctrl_t value) {
+    SetCtrl(ctrl_, capacity_, index, value);
+  }
+
+  // the slot of key, or capacity_; probes groups at growing distances
+  template <class K>
+  size_t FindIndex(const K& key, size_t hash) const {
+    if (!capacity_) return capacity_;
+
+    size_t mask{capacity_ - 1};
+    size_t position{H1(hash) & mask};
+    for (size_t step = kGroupWidth;; step += kGroupWidth) {
+      Group group(ctrl_ + position);
+      for (uint32_t match = group.Match(H2(hash)); match; match &= match - 1) {
+        size_t index{(position + LowestBit(match)) & mask};
+        if (equal_(KeyOf(slots_[index]), key)) return index;
+      }
+      if (group.MatchEmpty()) return capacity_;
+      position = (position + step) & mask;
+    }
+  }
+
+  // the first empty or deleted slot on the probe path of hash
+  static size_t FindFree(const ctrl_t* ctrl, size_t capacity, size_t hash) {
+    size_t mask{capacity - 1};
+    size_t position{H1(hash) & mask};
+    for (size_t step = kGroupWidth;; step += kGroupWidth) {
+      uint32_t free{Group(ctrl + position).MatchFree()};
+      if (free) return (position + LowestBit(free)) & mask;
+      position = (position + step) & mask;
+    }
+  }
+
+  size_t FindFree(size_t hash) const {
+    return FindFree(ctrl_, capacity_, hash);
+  }
+
+  // a free slot for a new value, rehashing first when taking an empty slot
+  // would pass the maximum load. The capacity doubles only if the values
+  // alone would leave less than 1/16 of the slots below that load, so a
+  // table filled mostly by tombstones keeps its size.
+  size_t PrepareInsert(size_t hash) {
+    size_t index{capacity_ ? FindFree(hash) : 0};
+    if (!capacity_ || (growth_left_ == 0 && ctrl_[index] == kEmpty)) {
+      size_t capacity{capacity_ ? capacity_ : kGroupWidth};
+      if (size_ + 1 > MaxLoad(capacity) - capacity / 16)
+        capacity *= 2;
+      Rehash(capacity);
+      index = FindFree(hash);
+    }
+    if (ctrl_[index] == kEmpty) growth_left_--;
+    return index;
+  }
+
+  // for values known to be absent, as when copying or rehashing
+  void InsertNew(const value_type& value) {
+    size_t hash{HashOf(KeyOf(value))};
+    size_t index{PrepareInsert(hash)};
+    new (slots_ + index) value_type(value);
+    SetCtrl(index, H2(hash));
+    size_++;
+  }
+
+  // builds the new arrays on the side and takes them only once every value
+  // is in place, so an allocation, a hash or a copy that throws leaves the
+  // table as it was. The slots are placed before any value is touched, and
+  // values are moved only when their move cannot throw.
+  void Rehash(size_t capacity) {
+    std::unique_ptr<ctrl_t[]> ctrl(new ctrl_t[capacity + kGroupWidth]);
+    std::memset(ctrl.get(), kEmpty, capacity + kGroupWidth);
+    std::unique_ptr<size_t[]> target(new size_t[size_]);
+    size_t count{0};
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (ctrl_[i] < 0) continue;
+
+      size_t hash{HashOf(KeyOf(slots_[i]))};
+      size_t index{FindFree(ctrl.get(), capacity, hash)};
+      SetCtrl(ctrl.get(), capacity, index, H2(hash));
+      target[count++] = index;
+    }
+
+    value_type* slots{static_cast<value_type*>(
+        ::operator new(capacity * sizeof(value_type)))};
+    count = 0;
+    try {
+      for (size_t i = 0; i < capacity_; ++i) {
+        if (ctrl_[i] < 0) continue;
+
+        new (slots + target[count])
+            value_type(std::move_if_noexcept(slots_[i]));
+        count++;
+      }
+    } catch (...) {
+      while (count) slots[target[--count]].~value_type();
+      ::operator delete(slots);
+      throw;
+    }
+
+    Release();
+    ctrl_ = ctrl.release();
+    slots_ = slots;
+    capacity_ = capacity;
+    growth_left_ = MaxLoad(capacity) - size_;
+  }
+
+  void Release() {
+    for (size_t i = 0; i < capacity_; ++i)
+      if (ctrl_[i] >= 0) slots_[i].~value_type();
+    delete[] ctrl_;
+    ::operator delete(slots_);
+  }
+};  // class HashTable
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_HASH_TABLE_H
@@ -0,0 +1,244 @@
+#ifndef SRC_IMPLEMENTATIONS_NODE_POOL_H
+#define SRC_IMPLEMENTATIONS_NODE_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+// Hands out raw storage for tree nodes from contiguous slabs. Freed slots go
+// to a free list and are reused first; the slabs themselves are released
+// together when the pool is destroyed. The pool never constructs or destroys
+// nodes, the owner does it in place.
+//
+// A node may be handed over to another pool without moving it (transfer),
+// so that trees can splice nodes between them. The slabs are reference
+// counted: the receiving pool holds on to the slab for as long as it keeps
+// nodes of it, and when it frees such a node the slot goes back to the slab,
+// where the pool that allocated it picks it up again once its own free list
+// runs dry. Pools share nothing else, so two trees that exchanged nodes may
+// still be used from different threads.
+template <class Node>
+class NodePool {
+  union Slot {
+    Slot* next;
+    alignas(Node) unsigned char storage[sizeof(Node)];
+  };
+
+  // slots given back by other pools are pushed onto returned from any thread
+  // and only ever taken all at once by the pool that allocated the slab
+  struct Slab {
+    explicit Slab(size_t count)
+        : slots{new Slot[count]}, count{count}, returned{nullptr} {}
+    ~Slab() { delete[] slots; }
+
+    Slab(const Slab&) = delete;
+    Slab& operator=(const Slab&) = delete;
+
+    Slot* slots;
+    size_t count;
+    std::atomic<Slot*> returned;
+  };
+
+  // a slab this pool allocated, or one it holds nodes of; nodes counts the
+  // latter and the share is dropped with its last node
+  struct Share {
+    std::shared_ptr<Slab> slab;
+    size_t nodes;
+    bool home;
+  };
+
+ public:
+  using size_type = size_t;
+
+  NodePool()
+      : slabs_(),
+        free_list_{nullptr},
+        cursor_{nullptr},
+        last_{nullptr},
+        capacity_{0},
+        available_{0},
+        borrowed_{0} {}
+
+  ~NodePool() { release(); }
+
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+
+  Node* allocate() {
+    if (!available_ && !Reclaim()) AddSlab(NextSlabSize());
+
+    Slot* slot{free_list_};
+    if (slot) {
+      free_list_ = slot->next;
+    } else {
+      slot = cursor_++;
+    }
+    available_--;
+    return reinterpret_cast<Node*>(slot->storage);
+  }
+
+  void deallocate(Node* node) {
+    Slot* slot{reinterpret_cast<Slot*>(node)};
+    if (borrowed_) {
+      auto share = Find(slot);
+      if (!share->home) {
+        Push(share->slab->returned, slot);
+        Drop(share);
+        return;
+      }
+    }
+    slot->next = free_list_;
+    free_list_ = slot;
+    available_++;
+  }
+
+  // makes room for count more nodes with at most one slab allocation
+  void reserve(size_type count) {
+    if (count > available_) AddSlab(count - available_);
+  }
+
+  size_type capacity() const { return capacity_; }
+
+  size_type available() const { return available_; }
+
+  // the nodes held that were allocated by other pools
+  size_type borrowed() const { return borrowed_; }
+
+  // allocates all it takes to receive any number of nodes of from, so the
+  // transfers that follow cannot fail
+  void prepare(const NodePool& from) {
+    slabs_.reserve(slabs_.size() + from.slabs_.size());
+  }
+
+  // hands a node held by this pool over to pool to, which must have been
+  // prepared for this one; the node itself stays where it is
+  void transfer(Node* node, NodePool& to) noexcept {
+    if (&to == this) return;
+
+    auto share = Find(reinterpret_cast<Slot*>(node));
+    to.Take(share->slab);
+    if (!share->home) Drop(share);
+  }
+
+  // frees every slab at once, all nodes must be destroyed by now; slabs
+  // that still have nodes in other pools live on with them
+  void release() {
+    slabs_.clear();
+    free_list_ = cursor_ = last_ = nullptr;
+    capacity_ = available_ = borrowed_ = 0;
+  }
+
+  void swap(NodePool& other) {
+    slabs_.swap(other.slabs_);
+    std::swap(free_list_, other.free_list_);
+    std::swap(cursor_, other.cursor_);
+    std::swap(last_, other.last_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(available_, other.available_);
+    std::swap(borrowed_, other.borrowed_);
+  }
+
+ private:
+  static constexpr size_type kMinSlab{32};
+  static constexpr size_type kMaxSlab{4096};
+
+  using share_iterator = typename std::vector<Share>::iterator;
+
+  // slabs grow with the pool, so small trees stay small
+  size_type NextSlabSize() const {
+    if (capacity_ < kMinSlab) return kMinSlab;
+    return capacity_ < kMaxSlab ? capacity_ : kMaxSlab;
+  }
+
+  void AddSlab(size_type count) {
+    std::shared_ptr<Slab> slab{std::make_shared<Slab>(count)};
+    slabs_.insert(Place(slab->slots), Share{slab, 0, true});
+
+    // the untouched tail of the current slab is kept on the free list
+    while (cursor_ != last_) {
+      cursor_->next = free_list_;
+      free_list_ = cursor_++;
+    }
+
+    cursor_ = slab->slots;
+    last_ = cursor_ + count;
+    capacity_ += count;
+    available_ += count;
+  }
+
+  // the shares are kept ordered by address; the first one past slot
+  share_iterator Place(const Slot* slot) {
+    return std::upper_bound(slabs_.begin(), slabs_.end(), slot,
+                            [](const Slot* slot, const Share& share) {
+                              return std::less<const Slot*>()(
+                                  slot, share.slab->slots);
+                            });
+  }
+
+  // the share of the slab holding slot, which must be one of this pool
+  share_iterator Find(const Slot* slot) { return Place(slot) - 1; }
+
+  void Take(const std::shared_ptr<Slab>& slab) noexcept {
+    share_iterator place{Place(slab->slots)};
+    borrowed_++;
+    if (place != slabs_.begin() && (place - 1)->slab == slab) {
+      if ((place - 1)->home) {
+        borrowed_--;
+      } else {
+        (place - 1)->nodes++;
+      }
+      return;
+    }
+    slabs_.insert(place, Share{slab, 1, false});
+  }
+
+  void Drop(share_iterator share) noexcept {
+    borrowed_--;
+    if (!--share->nodes) slabs_.erase(share);
+  }
+
+  static void Push(std::atomic<Slot*>& list, Slot* slot) {
+    slot->next = list.load(std::memory_order_relaxed);
+    while (!list.compare_exchange_weak(slot->next, slot,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  // collects the slots other pools gave back to this pool's slabs; the
+  // search only runs when the free list is empty
+  bool Reclaim() {
+    for (Share& share : slabs_) {
+      if (!share.home || !share.slab->returned.load(std::memory_order_relaxed))
+        continue;
+      Slot* slot{share.slab->returned.exchange(nullptr,
+                                               std::memory_order_acquire)};
+      while (slot) {
+        Slot* next{slot->next};
+        slot->next = free_list_;
+        free_list_ = slot;
+        available_++;
+        slot = next;
+      }
+    }
+    return available_ != 0;
+  }
+
+  // ordered by the address of the slab
+  std::vector<Share> slabs_;
+  Slot* free_list_;
+  Slot* cursor_;
+  Slot* last_;
+  size_type capacity_;
+  size_type available_;
+  size_type borrowed_;
+};  // class NodePool
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_NODE_POOL_H
@@ -0,0 +1,211 @@
+#ifndef SRC_IMPLEMENTATIONS_PARALLEL_H
+#define SRC_IMPLEMENTATIONS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+namespace parallel {
+// ranges shorter than this are not worth a thread of their own
+constexpr size_t kGrain{size_t{1} << 14};
+
+// the number of threads to use when the caller asks for threads; 0 means
+// one per hardware thread
+inline size_t Threads(size_t threads) {
+  if (threads) return threads;
+  unsigned hardware{std::thread::hardware_concurrency()};
+  return hardware ? hardware : 1;
+}
+
+// runs left on a new thread and right on this one and waits for both. An
+// exception from either is rethrown after the join, so the other side
+// always finishes first; without spare threads both run here in turn.
+template <class Left, class Right>
+void Fork(bool split, Left&& left, Right&& right) {
+  if (!split) {
+    left();
+    right();
+    return;
+  }
+
+  std::exception_ptr error;
+  std::thread worker;
+  try {
+    worker = std::thread([&left, &error] {
+      try {
+        left();
+      } catch (...) {
+        error = std::current_exception();
+      }
+    });
+  } catch (const std::system_error&) {
+    left();
+    right();
+    return;
+  }
+  try {
+    right();
+  } catch (...) {
+    worker.join();
+    throw;
+  }
+  worker.join();
+  if (error) std::rethrow_exception(error);
+}
+
+// merges two sorted runs into out, stable like std::merge: the longer run
+// is cut in the middle and the other at the matching bound, and both
+// halves are merged in parallel
+template <class T, class Less>
+void Merge(T* first1, T* last1, T* first2, T* last2, T* out, Less less,
+           size_t threads) {
+  size_t length1(last1 - first1);
+  size_t length2(last2 - first2);
+  if (threads <= 1 || length1 + length2 < 2 * kGrain) {
+    std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+               std::make_move_iterator(first2), std::make_move_iterator(last2),
+               out, less);
+    return;
+  }
+
+  T* middle1;
+  T* middle2;
+  if (length1 >= length2) {
+    middle1 = first1 + length1 / 2;
+    middle2 = std::lower_bound(first2, last2, *middle1, less);
+  } else {
+    middle2 = first2 + length2 / 2;
+    middle1 = std::upper_bound(first1, last1, *middle2, less);
+  }
+  T* middle_out{out + (middle1 - first1) + (middle2 - first2)};
+  Fork(
+      true,
+      [&] { Merge(first1, middle1, first2, middle2, out, less, threads / 2); },
+      [&] {
+        Merge(middle1, last1, middle2, last2, middle_out, less,
+              threads - threads / 2);
+      });
+}
+
+// stable merge sort of [first, last) on up to threads threads; buffer has
+// room for as many values. The halves are sorted into the other array, so
+// that merging them lands the result where it is wanted without copies.
+template <class T, class Less>
+void Sort(T* first, T* last, T* buffer, Less less, size_t threads,
+          bool into_buffer = false) {
+  size_t length(last - first);
+  if (threads <= 1 || length < 2 * kGrain) {
+    std::stable_sort(first, last, less);
+    if (into_buffer) std::move(first, last, buffer);
+    return;
+  }
+
+  size_t half{length / 2};
+  Fork(
+      true,
+      [&] {
+        Sort(first, first + half, buffer, less, threads / 2, !into_buffer);
+      },
+      [&] {
+        Sort(first + half, last, buffer + half, less, threads - threads / 2,
+             !into_buffer);
+      });
+  if (into_buffer) {
+    Merge(first, first + half, first + half, last, buffer, less, threads);
+  } else {
+    Merge(buffer, buffer + half, buffer + half, buffer + length, first, less,
+          threads);
+  }
+}
+
+// calls f(begin, end) on consecutive slices of [begin, end), one slice per
+// thread
+template <class Function>
+void ForRange(size_t begin, size_t end, size_t threads, Function& f) {
+  if (threads <= 1 || end - begin < 2 * kGrain) {
+    f(begin, end);
+    return;
+  }
+
+  size_t middle{begin + (end - begin) / 2};
+  Fork(
+      true, [&] { ForRange(begin, middle, threads / 2, f); },
+      [&] { ForRange(middle, end, threads - threads / 2, f); });
+}
+
+// runs run(0), ..., run(tasks - 1) on up to threads threads, the calling
+// one included. Every thread starts on its own consecutive share of the
+// tasks and takes them from the front; one that runs out steals from the
+// back of the other shares, so uneven tasks still keep all threads busy.
+// The first exception stops the remaining tasks and is rethrown.
+template <class Task>
+void RunTasks(size_t tasks, size_t threads, Task& run) {
+  threads = std::min(threads, tasks);
+  if (threads <= 1) {
+    for (size_t task = 0; task < tasks; ++task) run(task);
+    return;
+  }
+
+  // a cache line each, the owner and the thieves lock only their share
+  struct alignas(64) Share {
+    std::mutex mutex;
+    size_t next;
+    size_t last;
+  };
+  std::unique_ptr<Share[]> shares(new Share[threads]);
+  for (size_t i = 0; i < threads; ++i) {
+    shares[i].next = tasks * i / threads;
+    shares[i].last = tasks * (i + 1) / threads;
+  }
+
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&](size_t self) {
+    try {
+      size_t victim{self};
+      for (size_t tried = 0; tried < threads && !failed;) {
+        size_t task{tasks};
+        {
+          std::lock_guard<std::mutex> lock(shares[victim].mutex);
+          Share& share{shares[victim]};
+          if (share.next < share.last)
+            task = victim == self ? share.next++ : --share.last;
+        }
+        if (task != tasks) {
+          run(task);
+        } else {
+          victim = (victim + 1) % threads;
+          tried++;
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) error = std::current_exception();
+      failed = true;
+    }
+  };
+
+  // a share whose thread could not be started is stolen by the others
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  try {
+    for (size_t i = 1; i < threads; ++i) workers.emplace_back(work, i);
+  } catch (const std::system_error&) {
+  }
+  work(0);
+  for (std::thread& worker : workers) worker.join();
+  if (error) std::rethrow_exception(error);
+}
+}  // namespace parallel
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_PARALLEL_H
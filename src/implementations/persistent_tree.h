@@ -0,0 +1,387 @@
+#ifndef SRC_IMPLEMENTATIONS_PERSISTENT_TREE_H
+#define SRC_IMPLEMENTATIONS_PERSISTENT_TREE_H
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "tree.h"
+
+namespace s21 {
+// A balanced search tree whose nodes never change once built. An update
+// copies only the nodes on the path from the root to the change, O(log n)
+// of them, and shares every other subtree with the versions before it;
+// nodes are reference counted and go away with the last version that uses
+// them. The root is published with an atomic store, so a snapshot is one
+// atomic load and readers walk their version without locks while a writer
+// goes on. Writers must not run concurrently with each other.
+//
+// The tree is height balanced (AVL) rather than red-black: rebalancing
+// after an insert or erase only rotates nodes on the copied path, while
+// red-black erase fix-ups recolor siblings that would need copying too.
+template <class Key = int, class Value = Key,
+          class KeyOfValue = KeyIdentity<Key>,
+          class Compare = std::less<Key>>
+class PersistentTree {
+  struct node;
+  using link = std::shared_ptr<const node>;
+
+  struct node {
+    node(const Value& data, link left_child, link right_child)
+        : value(data),
+          left(std::move(left_child)),
+          right(std::move(right_child)),
+          height(1 + std::max(HeightOf(left), HeightOf(right))),
+          size(1 + SizeOf(left) + SizeOf(right)) {}
+
+    Value value;
+    link left;
+    link right;
+    unsigned height;
+    size_t size;
+  };
+
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+  using key_compare = Compare;
+
+  // walks one version in order with a stack of the ancestors still to
+  // visit; the version stays alive as long as the iterator does
+  class PersistentIterator {
+   public:
+    using value_type = Value;
+    using reference = const value_type&;
+    using pointer = const value_type*;
+    using iterator = PersistentIterator;
+
+    PersistentIterator() = default;
+
+    reference operator*() const { return path_.back()->value; }
+
+    pointer operator->() const { return &path_.back()->value; }
+
+    iterator& operator++() {
+      const node* current{path_.back()};
+      path_.pop_back();
+      PushLeftmost(current->right.get());
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator temp = *this;
+      ++(*this);
+      return temp;
+    }
+
+    bool operator==(const iterator& other) const {
+      if (path_.empty() || other.path_.empty())
+        return path_.empty() && other.path_.empty();
+      return path_.back() == other.path_.back();
+    }
+
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    link root_;
+    std::vector<const node*> path_;
+    friend class PersistentTree;
+
+    explicit PersistentIterator(link root) : root_(std::move(root)) {}
+
+    void PushLeftmost(const node* current) {
+      for (; current; current = current->left.get()) path_.push_back(current);
+    }
+  };  // class PersistentIterator
+
+  using iterator = PersistentIterator;
+  using const_iterator = PersistentIterator;
+
+  PersistentTree() : PersistentTree(Compare()) {}
+
+  explicit PersistentTree(const Compare& compare)
+      : root_{nullptr}, compare_{compare} {}
+
+  // O(1): the copy shares the nodes of the version it was made from
+  PersistentTree(const PersistentTree& other)
+      : root_{other.Root()}, compare_{other.compare_} {}
+
+  PersistentTree& operator=(const PersistentTree& other) {
+    if (this == &other) return *this;
+
+    compare_ = other.compare_;
+    Publish(other.Root());
+    return *this;
+  }
+
+  ~PersistentTree() = default;
+
+  // the current version, unaffected by later updates
+  PersistentTree snapshot() const { return *this; }
+
+  iterator begin() const {
+    iterator it(Root());
+    it.PushLeftmost(it.root_.get());
+    return it;
+  }
+
+  iterator end() const { return iterator(); }
+
+  bool empty() const { return !Root(); }
+
+  size_type size() const { return SizeOf(Root()); }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(node);
+  }
+
+  void clear() { Publish(nullptr); }
+
+  std::pair<iterator, bool> insert(const value_type& value, bool duplicate) {
+    bool inserted{false};
+    link root{Insert(Root(), value, duplicate, inserted)};
+    if (inserted) Publish(root);
+    // the copied path ends at the new value or at the one blocking it
+    return std::pair<iterator, bool>(
+        duplicate ? FindLast(root, KeyOf(value)) : find(KeyOf(value)),
+        inserted);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(bool duplicate, Args&&... args) {
+    return insert(value_type(std::forward<Args>(args)...), duplicate);
+  }
+
+  // removes one value with the key; false if there is none
+  bool erase(const key_type& key) {
+    bool erased{false};
+    link root{Erase(Root(), key, erased)};
+    if (erased) Publish(root);
+    return erased;
+  }
+
+  void swap(PersistentTree& other) {
+    link root{Root()};
+    Publish(other.Root());
+    other.Publish(root);
+    std::swap(compare_, other.compare_);
+  }
+
+  iterator find(const key_type& key) const {
+    iterator it{lower_bound(key)};
+    if (it == end() || Less(key, KeyOf(*it))) return end();
+    return it;
+  }
+
+  bool contains(const key_type& key) const {
+    link root{Root()};
+    const node* current{root.get()};
+    while (current) {
+      if (Less(key, KeyOf(current->value))) {
+        current = current->left.get();
+      } else if (Less(KeyOf(current->value), key)) {
+        current = current->right.get();
+      } else {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // the path keeps every node where the descent turned left, which are
+  // exactly the ancestors an in-order walk still has to visit
+  iterator lower_bound(const key_type& key) const {
+    iterator it(Root());
+    for (const node* current = it.root_.get(); current;) {
+      if (Less(KeyOf(current->value), key)) {
+        current = current->right.get();
+      } else {
+        it.path_.push_back(current);
+        current = current->left.get();
+      }
+    }
+    return it;
+  }
+
+  iterator upper_bound(const key_type& key) const {
+    iterator it(Root());
+    for (const node* current = it.root_.get(); current;) {
+      if (Less(key, KeyOf(current->value))) {
+        it.path_.push_back(current);
+        current = current->left.get();
+      } else {
+        current = current->right.get();
+      }
+    }
+    return it;
+  }
+
+  size_type count(const key_type& key) const {
+    size_type result{0};
+    for (iterator it{lower_bound(key)}; it != end() && !Less(key, KeyOf(*it));
+         ++it)
+      result++;
+    return result;
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+  // heights within one of each other and correct, sizes and order right
+  bool CheckBalance() const {
+    link root{Root()};
+    if (!CheckNode(root.get())) return false;
+
+    const value_type* previous{nullptr};
+    iterator it(root);
+    for (it.PushLeftmost(root.get()); it != end(); ++it) {
+      if (previous && Less(KeyOf(*it), KeyOf(*previous))) return false;
+      previous = &*it;
+    }
+    return true;
+  }
+
+ private:
+  link root_;
+  Compare compare_;
+
+  link Root() const { return std::atomic_load(&root_); }
+
+  void Publish(link root) { std::atomic_store(&root_, std::move(root)); }
+
+  static const key_type& KeyOf(const value_type& value) {
+    return KeyOfValue()(value);
+  }
+
+  template <class A, class B>
+  bool Less(const A& a, const B& b) const {
+    return compare_(a, b);
+  }
+
+  static unsigned HeightOf(const link& current) {
+    return current ? current->height : 0;
+  }
+
+  static size_t SizeOf(const link& current) {
+    return current ? current->size : 0;
+  }
+
+  static link Make(const value_type& value, link left, link right) {
+    return std::make_shared<const node>(value, std::move(left),
+                                        std::move(right));
+  }
+
+  // a new node over left and right, rotated when their heights differ by
+  // two; only new nodes are built, the children are shared
+  static link Balance(const value_type& value, link left, link right) {
+    unsigned left_height{HeightOf(left)};
+    unsigned right_height{HeightOf(right)};
+    if (left_height > right_height + 1) {
+      if (HeightOf(left->left) >= HeightOf(left->right))
+        return Make(left->value, left->left,
+                    Make(value, left->right, std::move(right)));
+      const node& inner{*left->right};
+      return Make(inner.value, Make(left->value, left->left, inner.left),
+                  Make(value, inner.right, std::move(right)));
+    }
+    if (right_height > left_height + 1) {
+      if (HeightOf(right->right) >= HeightOf(right->left))
+        return Make(right->value, Make(value, std::move(left), right->left),
+                    right->right);
+      const node& inner{*right->left};
+      return Make(inner.value, Make(value, std::move(left), inner.left),
+                  Make(right->value, inner.right, right->right));
+    }
+    return Make(value, std::move(left), std::move(right));
+  }
+
+  // equal keys go after the present ones
+  link Insert(const link& current, const value_type& value, bool duplicate,
+              bool& inserted) const {
+    if (!current) {
+      inserted = true;
+      return Make(value, nullptr, nullptr);
+    }
+    if (Less(KeyOf(value), KeyOf(current->value))) {
+      link left{Insert(current->left, value, duplicate, inserted)};
+      if (!inserted) return current;
+      return Balance(current->value, std::move(left), current->right);
+    }
+    if (!duplicate && !Less(KeyOf(current->value), KeyOf(value)))
+      return current;
+    link right{Insert(current->right, value, duplicate, inserted)};
+    if (!inserted) return current;
+    return Balance(current->value, current->left, std::move(right));
+  }
+
+  static link EraseMin(const link& current, const value_type*& minimum) {
+    if (!current->left) {
+      minimum = &current->value;
+      return current->right;
+    }
+    return Balance(current->value, EraseMin(current->left, minimum),
+                   current->right);
+  }
+
+  link Erase(const link& current, const key_type& key, bool& erased) const {
+    if (!current) return current;
+
+    if (Less(key, KeyOf(current->value))) {
+      link left{Erase(current->left, key, erased)};
+      if (!erased) return current;
+      return Balance(current->value, std::move(left), current->right);
+    }
+    if (Less(KeyOf(current->value), key)) {
+      link right{Erase(current->right, key, erased)};
+      if (!erased) return current;
+      return Balance(current->value, current->left, std::move(right));
+    }
+    erased = true;
+    if (!current->right) return current->left;
+    if (!current->left) return current->right;
+    const value_type* successor{nullptr};
+    link right{EraseMin(current->right, successor)};
+    return Balance(*successor, current->left, std::move(right));
+  }
+
+  // the last of the values with key in the version under root
+  iterator FindLast(const link& root, const key_type& key) const {
+    iterator it(root);
+    const node* found{nullptr};
+    std::vector<const node*> path;
+    for (const node* current = root.get(); current;) {
+      if (Less(key, KeyOf(current->value))) {
+        path.push_back(current);
+        current = current->left.get();
+      } else {
+        if (!Less(KeyOf(current->value), key)) {
+          found = current;
+          it.path_ = path;
+          it.path_.push_back(current);
+        }
+        current = current->right.get();
+      }
+    }
+    return found ? it : end();
+  }
+
+  static bool CheckNode(const node* current) {
+    if (!current) return true;
+
+    unsigned left{HeightOf(current->left)};
+    unsigned right{HeightOf(current->right)};
+    return current->height == 1 + std::max(left, right) &&
+           left <= right + 1 && right <= left + 1 &&
+           current->size ==
+               1 + SizeOf(current->left) + SizeOf(current->right) &&
+           CheckNode(current->left.get()) && CheckNode(current->right.get());
+  }
+};  // class PersistentTree
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_PERSISTENT_TREE_H
@@ -0,0 +1,99 @@
+#ifndef SRC_IMPLEMENTATIONS_s_BTREE_MULTISET_H
+#define SRC_IMPLEMENTATIONS_s_BTREE_MULTISET_H
+
+#include "s_btree_set.h"
+#include "s_vector.h"
+
+namespace s21 {
+template <typename Key, typename Compare = std::less<Key>,
+          size_t FanOut = BtreeDefaultFanOut<Key>()>
+class btree_multiset : public s21::btree_set<Key, Compare, FanOut> {
+ public:
+  using key_type = Key;
+  using key_compare = Compare;
+  using value_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = size_t;
+  using tree_type = typename s21::btree_set<Key, Compare, FanOut>::tree_type;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+
+  btree_multiset() : s21::btree_set<Key, Compare, FanOut>() {}
+  explicit btree_multiset(const key_compare& compare)
+      : s21::btree_set<Key, Compare, FanOut>(compare) {}
+
+  btree_multiset(std::initializer_list<value_type> const& items) {
+    for (const value_type& item : items) tree_type::insert(item, 1);
+  }
+
+  template <class Iterator>
+  btree_multiset(Iterator first, Iterator last) {
+    tree_type items(first, last, 1);
+    tree_type::swap(items);
+  }
+
+  btree_multiset(const btree_multiset& ms)
+      : s21::btree_set<Key, Compare, FanOut>(ms) {}
+  btree_multiset(btree_multiset&& ms)
+      : s21::btree_set<Key, Compare, FanOut>(std::move(ms)) {}
+  ~btree_multiset() = default;
+
+  btree_multiset& operator=(btree_multiset&& ms) {
+    tree_type::operator=(std::move(ms));
+    return *this;
+  }
+
+  btree_multiset& operator=(const btree_multiset& ms) {
+    tree_type::operator=(ms);
+    return *this;
+  }
+
+  /* Modifiers */
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return tree_type::insert(value, 1);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree_type::emplace(1, std::forward<Args>(args)...);
+  }
+
+  iterator insert(iterator, const value_type& value) {
+    return insert(value).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator, Args&&... args) {
+    return emplace(std::forward<Args>(args)...).first;
+  }
+
+  void merge(btree_multiset& other) { tree_type::merge(other, 1); }
+
+  /*Part3*/
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    std::initializer_list<value_type> items{std::forward<Args>(args)...};
+    std::vector<std::pair<iterator, bool>> result;
+    for (auto& n : items) {
+      result.push_back(insert(n));
+    }
+    // an insert may move the values earlier iterators pointed to, so they
+    // are looked up once everything is in. Equal values keep their
+    // insertion order: an item's copy sits before those of the equal items
+    // after it.
+    key_compare less{this->key_comp()};
+    const value_type* values{items.begin()};
+    for (size_t i = 0; i < items.size(); ++i) {
+      iterator it{this->upper_bound(values[i])};
+      --it;
+      for (size_t j = i + 1; j < items.size(); ++j)
+        if (!less(values[i], values[j]) && !less(values[j], values[i])) --it;
+      result[i].first = it;
+    }
+    return result;
+  }
+};
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_BTREE_MULTISET_H
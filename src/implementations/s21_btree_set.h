@@ -0,0 +1,143 @@
+#ifndef SRC_IMPLEMENTATIONS_s_BTREE_SET_H
+#define SRC_IMPLEMENTATIONS_s_BTREE_SET_H
+
+#include "btree.h"
+#include "s_vector.h"
+
+namespace s21 {
+// s21::set on a B-tree: several keys per node make lookups and ordered
+// scans cache friendly, at the price of iterators that insert and erase
+// invalidate
+template <typename Key, typename Compare = std::less<Key>,
+          size_t FanOut = BtreeDefaultFanOut<Key>()>
+class btree_set
+    : protected s21::BTree<Key, Key, s21::KeyIdentity<Key>, Compare, FanOut> {
+ public:
+  using key_type = Key;
+  using key_compare = Compare;
+  using tree_type =
+      s21::BTree<Key, Key, s21::KeyIdentity<Key>, Compare, FanOut>;
+  using value_type = Key;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+
+  btree_set() : tree_type() {}
+  explicit btree_set(const key_compare &compare) : tree_type(compare) {}
+  btree_set(std::initializer_list<value_type> const &items)
+      : tree_type(items, 0) {}
+  template <class Iterator>
+  btree_set(Iterator first, Iterator last) : tree_type(first, last, 0) {}
+  btree_set(const btree_set &s) : tree_type(s) {}
+  btree_set(btree_set &&s) : tree_type(std::move(s)) {}
+  ~btree_set() = default;
+
+  btree_set &operator=(btree_set &&s) {
+    tree_type::operator=(std::move(s));
+    return *this;
+  }
+
+  btree_set &operator=(const btree_set &s) {
+    tree_type::operator=(s);
+    return *this;
+  }
+
+  /* Iterators */
+  iterator begin() { return tree_type::begin(); }
+  iterator end() { return tree_type::end(); }
+
+  /* Capacity */
+  bool empty() const { return tree_type::empty(); }
+  size_type size() const { return tree_type::size(); }
+  size_type max_size() const { return tree_type::max_size(); }
+
+  /* Modifiers */
+  void clear() { tree_type::clear(); }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return tree_type::insert(value, 0);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return tree_type::emplace(0, std::forward<Args>(args)...);
+  }
+
+  // the hint is accepted for compatibility with s21::set only: a descent
+  // touches a handful of nodes anyway
+  iterator insert(iterator, const value_type &value) {
+    return insert(value).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator, Args &&...args) {
+    return emplace(std::forward<Args>(args)...).first;
+  }
+
+  void erase(iterator pos) { tree_type::erase(pos); }
+  void swap(btree_set &other) { tree_type::swap(other); }
+  void merge(btree_set &other) { tree_type::merge(other, 0); }
+
+  /* Lookup */
+  iterator find(const key_type &key) { return tree_type::find(key); }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator find(const K &key) {
+    return tree_type::find(key);
+  }
+  bool contains(const key_type &key) { return tree_type::contains(key); }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  bool contains(const K &key) {
+    return tree_type::contains(key);
+  }
+  size_type count(const key_type &key) const { return tree_type::count(key); }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count(const K &key) const {
+    return tree_type::count(key);
+  }
+  std::pair<iterator, iterator> equal_range(const key_type &key) const {
+    return tree_type::equal_range(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K &key) const {
+    return tree_type::equal_range(key);
+  }
+  iterator lower_bound(const key_type &key) const {
+    return tree_type::lower_bound(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator lower_bound(const K &key) const {
+    return tree_type::lower_bound(key);
+  }
+  iterator upper_bound(const key_type &key) const {
+    return tree_type::upper_bound(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator upper_bound(const K &key) const {
+    return tree_type::upper_bound(key);
+  }
+
+  key_compare key_comp() const { return tree_type::key_comp(); }
+
+  using tree_type::CheckBalance;
+
+  /*Part3*/
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    std::initializer_list<value_type> items{std::forward<Args>(args)...};
+    std::vector<std::pair<iterator, bool>> result;
+    for (auto &n : items) {
+      result.push_back(insert(n));
+    }
+    // an insert may move the values earlier iterators pointed to, so they
+    // are looked up once everything is in
+    auto item = items.begin();
+    for (auto &entry : result) entry.first = find(*item++);
+    return result;
+  }
+};  // class btree_set
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_BTREE_SET_H
@@ -0,0 +1,242 @@
+#ifndef SRC_IMPLEMENTATIONS_s_CONCURRENT_MAP_H
+#define SRC_IMPLEMENTATIONS_s_CONCURRENT_MAP_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <shared_mutex>
+#include <type_traits>
+#include <vector>
+
+#include "s_map.h"
+
+namespace s21 {
+// An ordered map for many threads: the keys are spread by hash over a
+// fixed number of shards, each an s21::map behind its own lock, so threads
+// touching different shards never wait for each other. With
+// std::shared_mutex as Mutex lookups take the lock shared and run in
+// parallel with each other (see concurrent_rw_map). There are no iterators
+// into the shards; values are copied out, and ordered walks copy every
+// shard under all the locks and merge the copies after releasing them.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Hash = std::hash<Key>, typename Mutex = std::mutex>
+class concurrent_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using key_compare = Compare;
+  using hasher = Hash;
+  using value_type = std::pair<key_type, mapped_type>;
+  using size_type = size_t;
+  using shard_type = s21::map<Key, T, Compare>;
+
+  static constexpr size_type kDefaultShards{16};
+
+  // hash picks the shard of a key, compare orders the keys of every shard
+  explicit concurrent_map(size_type shards = kDefaultShards,
+                          const hasher &hash = hasher(),
+                          const key_compare &compare = key_compare())
+      : shards_(new Shard[shards ? shards : 1]),
+        shards_count_{shards ? shards : 1},
+        hash_{hash} {
+    for (size_type i = 0; i < shards_count_; ++i)
+      shards_[i].map = shard_type(compare);
+  }
+
+  concurrent_map(const concurrent_map &) = delete;
+  concurrent_map &operator=(const concurrent_map &) = delete;
+  ~concurrent_map() = default;
+
+  // Capacity; exact only while no other thread writes
+  bool empty() const { return size() == 0; }
+
+  size_type size() const {
+    size_type result{0};
+    for (size_type i = 0; i < shards_count_; ++i) {
+      ReadLock lock(shards_[i].mutex);
+      result += shards_[i].map.size();
+    }
+    return result;
+  }
+
+  size_type shards() const { return shards_count_; }
+
+  hasher hash_function() const { return hash_; }
+
+  key_compare key_comp() const { return shards_[0].map.key_comp(); }
+
+  // Modifiers
+  void clear() {
+    for (size_type i = 0; i < shards_count_; ++i) {
+      WriteLock lock(shards_[i].mutex);
+      shards_[i].map.clear();
+    }
+  }
+
+  bool insert(const Key &key, const T &obj) {
+    Shard &shard{ShardOf(key)};
+    WriteLock lock(shard.mutex);
+    return shard.map.insert(key, obj).second;
+  }
+
+  bool insert_or_assign(const Key &key, const T &obj) {
+    Shard &shard{ShardOf(key)};
+    WriteLock lock(shard.mutex);
+    return shard.map.insert_or_assign(key, obj).second;
+  }
+
+  bool erase(const Key &key) {
+    Shard &shard{ShardOf(key)};
+    WriteLock lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) return false;
+
+    shard.map.erase(it);
+    return true;
+  }
+
+  // sorts the pairs by shard first, then takes every shard lock once;
+  // returns how many keys were new
+  template <class Iterator>
+  size_type insert_many(Iterator first, Iterator last) {
+    std::vector<std::vector<value_type>> batches(shards_count_);
+    for (; first != last; ++first)
+      batches[IndexOf(first->first)].push_back(*first);
+
+    size_type inserted{0};
+    for (size_type i = 0; i < shards_count_; ++i) {
+      if (batches[i].empty()) continue;
+
+      WriteLock lock(shards_[i].mutex);
+      for (const value_type &item : batches[i])
+        inserted += shards_[i].map.insert(item.first, item.second).second;
+    }
+    return inserted;
+  }
+
+  size_type insert_many(std::initializer_list<value_type> const &items) {
+    return insert_many(items.begin(), items.end());
+  }
+
+  // calls f on the mapped value of key under the shard's write lock
+  template <class Function>
+  bool update(const Key &key, Function f) {
+    Shard &shard{ShardOf(key)};
+    WriteLock lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) return false;
+
+    f(it->second);
+    return true;
+  }
+
+  // Lookup
+  std::optional<T> find(const Key &key) const {
+    Shard &shard{ShardOf(key)};
+    ReadLock lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) return std::nullopt;
+    return it->second;
+  }
+
+  bool contains(const Key &key) const {
+    Shard &shard{ShardOf(key)};
+    ReadLock lock(shard.mutex);
+    return shard.map.contains(key);
+  }
+
+  // calls f(key, value) for every pair in key order. The shard locks are
+  // held, all at once and taken in index order like any other multi-shard
+  // call, only while the pairs are copied out; the merge and f run without
+  // them, so f may call back into the map and writers wait only for the
+  // copy. f sees the pairs as they were at that moment.
+  template <class Function>
+  void for_each(Function f) const {
+    std::vector<std::vector<value_type>> runs{CopyShards()};
+
+    using run_iterator = typename std::vector<value_type>::const_iterator;
+    struct Cursor {
+      run_iterator current;
+      run_iterator last;
+    };
+    key_compare compare{key_comp()};
+    auto later = [&compare](const Cursor &a, const Cursor &b) {
+      return compare(b.current->first, a.current->first);
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heads(
+        later);
+    for (const std::vector<value_type> &run : runs) {
+      if (!run.empty()) heads.push(Cursor{run.begin(), run.end()});
+    }
+    while (!heads.empty()) {
+      Cursor cursor{heads.top()};
+      heads.pop();
+      f(cursor.current->first, cursor.current->second);
+      if (++cursor.current != cursor.last) heads.push(cursor);
+    }
+  }
+
+  // an ordered copy of the contents
+  s21::map<Key, T, Compare> snapshot() const {
+    std::vector<value_type> items;
+    for_each([&items](const Key &key, const T &obj) {
+      items.emplace_back(key, obj);
+    });
+    s21::map<Key, T, Compare> result(key_comp());
+    result.build_from_sorted(items.begin(), items.end());
+    return result;
+  }
+
+ private:
+  static constexpr bool kShared{std::is_same<Mutex, std::shared_mutex>::value};
+
+  using ReadLock = typename std::conditional<kShared, std::shared_lock<Mutex>,
+                                             std::unique_lock<Mutex>>::type;
+  using WriteLock = std::unique_lock<Mutex>;
+
+  // a cache line each, so that locking one shard does not slow the next
+  struct alignas(64) Shard {
+    mutable Mutex mutex;
+    mutable shard_type map;
+  };
+
+  std::unique_ptr<Shard[]> shards_;
+  size_type shards_count_;
+  Hash hash_;
+
+  // std::hash of integers is the identity, so neighbouring keys are mixed
+  // apart before picking a shard
+  size_type IndexOf(const Key &key) const {
+    size_t hash{hash_(key) * size_t{0x9E3779B97F4A7C15ULL}};
+    return (hash ^ (hash >> 29)) % shards_count_;
+  }
+
+  Shard &ShardOf(const Key &key) const { return shards_[IndexOf(key)]; }
+
+  // the pairs of every shard in key order, copied under all the shard
+  // locks so that together they are one state of the map
+  std::vector<std::vector<value_type>> CopyShards() const {
+    std::vector<ReadLock> locks;
+    locks.reserve(shards_count_);
+    for (size_type i = 0; i < shards_count_; ++i)
+      locks.emplace_back(shards_[i].mutex);
+
+    std::vector<std::vector<value_type>> runs(shards_count_);
+    for (size_type i = 0; i < shards_count_; ++i) {
+      runs[i].reserve(shards_[i].map.size());
+      for (const value_type &item : shards_[i].map) runs[i].push_back(item);
+    }
+    return runs;
+  }
+};
+
+// a concurrent_map whose lookups share their shard lock
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Hash = std::hash<Key>>
+using concurrent_rw_map =
+    concurrent_map<Key, T, Compare, Hash, std::shared_mutex>;
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_CONCURRENT_MAP_H
@@ -0,0 +1,208 @@
+#ifndef SRC_IMPLEMENTATIONS_s_COUNTED_MULTISET_H
+#define SRC_IMPLEMENTATIONS_s_COUNTED_MULTISET_H
+
+#include "s_vector.h"
+#include "tree.h"
+
+namespace s21 {
+// A multiset that keeps every distinct key in one node together with the
+// number of its copies. Iteration still yields each copy, count is a single
+// lookup, and inserting or erasing a copy of a present key only changes the
+// counter, not the tree.
+template <typename Key, typename Compare = std::less<Key>>
+class counted_multiset {
+  using node_value = std::pair<Key, size_t>;
+
+ public:
+  using key_type = Key;
+  using key_compare = Compare;
+  using value_type = Key;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using tree_type =
+      s21::RBtree<key_type, node_value, s21::KeySelectFirst<node_value>,
+                  Compare>;
+
+  // a node of the tree and the copy of its key within the node
+  class CountedIterator {
+   public:
+    using value_type = Key;
+    using reference = const value_type &;
+    using pointer = const value_type *;
+    using iterator = CountedIterator;
+
+    CountedIterator(typename tree_type::iterator node, size_type copy)
+        : node_(node), copy_(copy) {}
+
+    reference operator*() const { return node_->first; }
+
+    pointer operator->() const { return &node_->first; }
+
+    iterator &operator++() {
+      if (++copy_ == node_->second) {
+        ++node_;
+        copy_ = 0;
+      }
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator temp = *this;
+      ++(*this);
+      return temp;
+    }
+
+    iterator &operator--() {
+      if (copy_) {
+        --copy_;
+      } else {
+        --node_;
+        copy_ = node_->second - 1;
+      }
+      return *this;
+    }
+
+    iterator operator--(int) {
+      iterator temp = *this;
+      --(*this);
+      return temp;
+    }
+
+    bool operator==(const iterator &other) const {
+      return node_ == other.node_ && copy_ == other.copy_;
+    }
+
+    bool operator!=(const iterator &other) const { return !(*this == other); }
+
+   private:
+    typename tree_type::iterator node_;
+    size_type copy_;
+    friend class counted_multiset;
+  };  // class CountedIterator
+
+  using iterator = CountedIterator;
+  using const_iterator = CountedIterator;
+
+  counted_multiset() : tree_(), size_{0} {}
+
+  explicit counted_multiset(const key_compare &compare)
+      : tree_(compare), size_{0} {}
+
+  counted_multiset(std::initializer_list<value_type> const &items)
+      : counted_multiset(items.begin(), items.end()) {}
+
+  template <class Iterator>
+  counted_multiset(Iterator first, Iterator last) : counted_multiset() {
+    for (; first != last; ++first) insert(*first);
+  }
+
+  counted_multiset(const counted_multiset &other)
+      : tree_(other.tree_), size_{other.size_} {}
+
+  counted_multiset(counted_multiset &&other) : counted_multiset() {
+    swap(other);
+  }
+
+  ~counted_multiset() = default;
+
+  counted_multiset &operator=(const counted_multiset &other) {
+    tree_ = other.tree_;
+    size_ = other.size_;
+    return *this;
+  }
+
+  counted_multiset &operator=(counted_multiset &&other) {
+    clear();
+    swap(other);
+    return *this;
+  }
+
+  /* Iterators */
+  iterator begin() { return iterator(tree_.begin(), 0); }
+  iterator end() { return iterator(tree_.end(), 0); }
+  const_iterator begin() const { return const_iterator(tree_.begin(), 0); }
+  const_iterator end() const { return const_iterator(tree_.end(), 0); }
+
+  /* Capacity */
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  // the number of different keys, that is of tree nodes
+  size_type distinct_size() const { return tree_.size(); }
+  size_type max_size() const { return tree_.max_size(); }
+
+  /* Modifiers */
+  void clear() {
+    tree_.clear();
+    size_ = 0;
+  }
+
+  // returns the last copy of the key
+  std::pair<iterator, bool> insert(const value_type &value) {
+    typename tree_type::iterator node{tree_.try_emplace(value, value, 0).first};
+    size_++;
+    return std::pair<iterator, bool>(iterator(node, node->second++), true);
+  }
+
+  // removes one copy; the node goes only with the last copy of its key
+  void erase(iterator pos) {
+    if (pos.node_->second > 1) {
+      pos.node_->second--;
+    } else {
+      tree_.erase(pos.node_);
+    }
+    size_--;
+  }
+
+  void swap(counted_multiset &other) {
+    tree_.swap(other.tree_);
+    std::swap(size_, other.size_);
+  }
+
+  // adds the counters of other, which is left empty
+  void merge(counted_multiset &other) {
+    if (this == &other) return;
+
+    for (const node_value &item : other.tree_)
+      tree_.try_emplace(item.first, item.first, 0).first->second +=
+          item.second;
+    size_ += other.size_;
+    other.clear();
+  }
+
+  /* Lookup */
+  size_type count(const key_type &key) const {
+    typename tree_type::iterator node{tree_.find(key)};
+    return node == tree_.end() ? 0 : node->second;
+  }
+
+  iterator find(const key_type &key) const {
+    return iterator(tree_.find(key), 0);
+  }
+
+  bool contains(const key_type &key) const { return tree_.contains(key); }
+
+  iterator lower_bound(const key_type &key) const {
+    return iterator(tree_.lower_bound(key), 0);
+  }
+
+  iterator upper_bound(const key_type &key) const {
+    return iterator(tree_.upper_bound(key), 0);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type &key) const {
+    return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  bool CheckBalance() const { return tree_.CheckBalance(); }
+
+ private:
+  tree_type tree_;
+  size_type size_;
+};  // class counted_multiset
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_COUNTED_MULTISET_H
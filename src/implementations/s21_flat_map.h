@@ -0,0 +1,225 @@
+#ifndef SRC_IMPLEMENTATIONS_s_FLAT_MAP_H
+#define SRC_IMPLEMENTATIONS_s_FLAT_MAP_H
+
+#include <tuple>
+
+#include "flat_tree.h"
+#include "s_vector.h"
+
+namespace s21 {
+// s21::map over one sorted s21::vector of pairs; insert and erase shift
+// the tail and invalidate iterators
+template <typename Key = int, typename T = int,
+          typename Compare = std::less<Key>>
+class flat_map {
+ public:
+  // Member type
+  using key_type = Key;
+  using mapped_type = T;
+  using key_compare = Compare;
+  using value_type = std::pair<key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using tree_type =
+      s21::FlatTree<key_type, value_type, s21::KeySelectFirst<value_type>,
+                    Compare>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = size_t;
+
+  // Member functions
+  flat_map() : tree_() {}
+
+  explicit flat_map(const key_compare &compare) : tree_(compare) {}
+
+  flat_map(std::initializer_list<value_type> const &items)
+      : tree_(items, false) {}
+
+  template <class Iterator>
+  flat_map(Iterator first, Iterator last) : tree_(first, last, false) {}
+
+  flat_map(const flat_map &m) : tree_(m.tree_) {}
+
+  flat_map(flat_map &&m) : tree_() { tree_.swap(m.tree_); }
+
+  ~flat_map() = default;
+
+  flat_map &operator=(const flat_map &m) {
+    tree_ = m.tree_;
+    return *this;
+  }
+
+  flat_map &operator=(flat_map &&m) {
+    tree_.clear();
+    tree_.swap(m.tree_);
+    return *this;
+  }
+
+  // Element access
+  T &at(const Key &key) {
+    iterator i = find(key);
+    if (i == end()) {
+      throw std::invalid_argument("\"s_flat_map::at\" key not found");
+    }
+    return i->second;
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  T &at(const K &key) {
+    iterator i = find(key);
+    if (i == end()) {
+      throw std::invalid_argument("\"s_flat_map::at\" key not found");
+    }
+    return i->second;
+  }
+
+  T &operator[](const Key &key) { return try_emplace(key).first->second; }
+
+  // iterators
+  iterator begin() { return tree_.begin(); }
+
+  iterator end() { return tree_.end(); }
+
+  // Capacity
+  bool empty() const { return tree_.empty(); }
+
+  size_type size() const { return tree_.size(); }
+
+  size_type max_size() const noexcept { return tree_.max_size(); }
+
+  void reserve(size_type count) { tree_.reserve(count); }
+
+  size_type capacity() { return tree_.capacity(); }
+
+  void shrink_to_fit() { tree_.shrink_to_fit(); }
+
+  // Modifiers
+  void clear() { tree_.clear(); }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return tree_.insert(value, 0);
+  }
+
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    return tree_.try_emplace(key, key, obj);
+  }
+
+  std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj) {
+    std::pair<iterator, bool> result{tree_.try_emplace(key, key, obj)};
+    if (!result.second) result.first->second = obj;
+
+    return result;
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return tree_.emplace(0, std::forward<Args>(args)...);
+  }
+
+  iterator insert(iterator hint, const value_type &value) {
+    return tree_.insert(hint, value, 0).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator hint, Args &&...args) {
+    return insert(hint, value_type(std::forward<Args>(args)...));
+  }
+
+  // the mapped value is built from args only when the key is new
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return tree_.try_emplace(
+        key, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  // sorts the range once and merges it in; of equal keys the value already
+  // here, or else the first one in the range, wins
+  template <class Iterator>
+  void insert_range(Iterator first, Iterator last) {
+    tree_.insert_range(first, last, false);
+  }
+
+  // replaces the contents in O(n), the range must be sorted by key
+  template <class Iterator>
+  void build_from_sorted(Iterator first, Iterator last) {
+    tree_.build_from_sorted(first, last, false);
+  }
+
+  void erase(iterator pos) { tree_.erase(pos); }
+
+  void swap(flat_map &other) { tree_.swap(other.tree_); }
+
+  void merge(flat_map &other) { tree_.merge(other.tree_, 0); }
+
+  // Lookup
+  bool contains(const Key &key) const { return tree_.contains(key); }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  bool contains(const K &key) const {
+    return tree_.contains(key);
+  }
+
+  iterator find(const Key &key) const { return tree_.find(key); }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator find(const K &key) const {
+    return tree_.find(key);
+  }
+
+  size_type count(const Key &key) const { return tree_.count(key); }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count(const K &key) const {
+    return tree_.count(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key &key) const {
+    return tree_.equal_range(key);
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K &key) const {
+    return tree_.equal_range(key);
+  }
+
+  iterator lower_bound(const Key &key) const { return tree_.lower_bound(key); }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator lower_bound(const K &key) const {
+    return tree_.lower_bound(key);
+  }
+
+  iterator upper_bound(const Key &key) const { return tree_.upper_bound(key); }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator upper_bound(const K &key) const {
+    return tree_.upper_bound(key);
+  }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  bool CheckBalance() const { return tree_.CheckBalance(); }
+
+  // part3*
+  template <typename... key_type, typename... mapped_type>
+  std::vector<std::pair<iterator, bool>> insert_many(
+      std::pair<key_type, mapped_type> &&...args) {
+    auto items = {args...};
+    std::vector<std::pair<iterator, bool>> ret;
+    for (const auto &arg : items) {
+      ret.push_back(insert(arg.first, arg.second));
+    }
+    // an insert may move the values earlier iterators pointed to, so they
+    // are looked up once everything is in
+    auto item = items.begin();
+    for (auto &entry : ret) entry.first = find((item++)->first);
+    return ret;
+  }
+
+ private:
+  tree_type tree_;
+};
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_FLAT_MAP_H
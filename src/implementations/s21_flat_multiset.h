@@ -0,0 +1,106 @@
+#ifndef SRC_IMPLEMENTATIONS_s_FLAT_MULTISET_H
+#define SRC_IMPLEMENTATIONS_s_FLAT_MULTISET_H
+
+#include "s_flat_set.h"
+#include "s_vector.h"
+
+namespace s21 {
+template <typename Key, typename Compare = std::less<Key>>
+class flat_multiset : public s21::flat_set<Key, Compare> {
+ public:
+  using key_type = Key;
+  using key_compare = Compare;
+  using value_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = size_t;
+  using tree_type = typename s21::flat_set<Key, Compare>::tree_type;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+
+  flat_multiset() : s21::flat_set<Key, Compare>() {}
+  explicit flat_multiset(const key_compare& compare)
+      : s21::flat_set<Key, Compare>(compare) {}
+
+  flat_multiset(std::initializer_list<value_type> const& items) {
+    tree_type::insert_range(items.begin(), items.end(), 1);
+  }
+
+  template <class Iterator>
+  flat_multiset(Iterator first, Iterator last) {
+    tree_type::insert_range(first, last, 1);
+  }
+
+  flat_multiset(const flat_multiset& ms) : s21::flat_set<Key, Compare>(ms) {}
+  flat_multiset(flat_multiset&& ms)
+      : s21::flat_set<Key, Compare>(std::move(ms)) {}
+  ~flat_multiset() = default;
+
+  flat_multiset& operator=(flat_multiset&& ms) {
+    tree_type::operator=(std::move(ms));
+    return *this;
+  }
+
+  flat_multiset& operator=(const flat_multiset& ms) {
+    tree_type::operator=(ms);
+    return *this;
+  }
+
+  /* Modifiers */
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return tree_type::insert(value, 1);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree_type::emplace(1, std::forward<Args>(args)...);
+  }
+
+  iterator insert(iterator hint, const value_type& value) {
+    return tree_type::insert(hint, value, 1).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator hint, Args&&... args) {
+    return insert(hint, value_type(std::forward<Args>(args)...));
+  }
+
+  template <class Iterator>
+  void insert_range(Iterator first, Iterator last) {
+    tree_type::insert_range(first, last, 1);
+  }
+
+  template <class Iterator>
+  void build_from_sorted(Iterator first, Iterator last) {
+    tree_type::build_from_sorted(first, last, 1);
+  }
+
+  void merge(flat_multiset& other) { tree_type::merge(other, 1); }
+
+  /*Part3*/
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    std::initializer_list<value_type> items{std::forward<Args>(args)...};
+    std::vector<std::pair<iterator, bool>> result;
+    for (auto& n : items) {
+      result.push_back(insert(n));
+    }
+    // an insert may move the values earlier iterators pointed to, so they
+    // are looked up once everything is in. Equal values keep their
+    // insertion order: an item's copy sits before those of the equal items
+    // after it.
+    key_compare less{this->key_comp()};
+    const value_type* values{items.begin()};
+    for (size_t i = 0; i < items.size(); ++i) {
+      iterator it{this->upper_bound(values[i])};
+      --it;
+      for (size_t j = i + 1; j < items.size(); ++j)
+        if (!less(values[i], values[j]) && !less(values[j], values[i])) --it;
+      result[i].first = it;
+    }
+    return result;
+  }
+};
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_FLAT_MULTISET_H
@@ -0,0 +1,156 @@
+#ifndef SRC_IMPLEMENTATIONS_s_FLAT_SET_H
+#define SRC_IMPLEMENTATIONS_s_FLAT_SET_H
+
+#include "flat_tree.h"
+#include "s_vector.h"
+
+namespace s21 {
+// s21::set over one sorted s21::vector: the smallest footprint and the
+// fastest scans, suited to sets that are built once and then mostly read
+template <typename Key, typename Compare = std::less<Key>>
+class flat_set
+    : protected s21::FlatTree<Key, Key, s21::KeyIdentity<Key>, Compare> {
+ public:
+  using key_type = Key;
+  using key_compare = Compare;
+  using tree_type = s21::FlatTree<Key, Key, s21::KeyIdentity<Key>, Compare>;
+  using value_type = Key;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+
+  flat_set() : tree_type() {}
+  explicit flat_set(const key_compare &compare) : tree_type(compare) {}
+  flat_set(std::initializer_list<value_type> const &items)
+      : tree_type(items, 0) {}
+  template <class Iterator>
+  flat_set(Iterator first, Iterator last) : tree_type(first, last, 0) {}
+  flat_set(const flat_set &s) : tree_type(s) {}
+  flat_set(flat_set &&s) : tree_type(std::move(s)) {}
+  ~flat_set() = default;
+
+  flat_set &operator=(flat_set &&s) {
+    tree_type::operator=(std::move(s));
+    return *this;
+  }
+
+  flat_set &operator=(const flat_set &s) {
+    tree_type::operator=(s);
+    return *this;
+  }
+
+  /* Iterators */
+  iterator begin() { return tree_type::begin(); }
+  iterator end() { return tree_type::end(); }
+
+  /* Capacity */
+  bool empty() const { return tree_type::empty(); }
+  size_type size() const { return tree_type::size(); }
+  size_type max_size() const { return tree_type::max_size(); }
+  void reserve(size_type count) { tree_type::reserve(count); }
+  size_type capacity() { return tree_type::capacity(); }
+  void shrink_to_fit() { tree_type::shrink_to_fit(); }
+
+  /* Modifiers */
+  void clear() { tree_type::clear(); }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return tree_type::insert(value, 0);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return tree_type::emplace(0, std::forward<Args>(args)...);
+  }
+
+  iterator insert(iterator hint, const value_type &value) {
+    return tree_type::insert(hint, value, 0).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator hint, Args &&...args) {
+    return insert(hint, value_type(std::forward<Args>(args)...));
+  }
+
+  // sorts the range once and merges it in, much faster than one insert
+  // per value
+  template <class Iterator>
+  void insert_range(Iterator first, Iterator last) {
+    tree_type::insert_range(first, last, 0);
+  }
+
+  // replaces the contents in O(n), the range must be sorted
+  template <class Iterator>
+  void build_from_sorted(Iterator first, Iterator last) {
+    tree_type::build_from_sorted(first, last, 0);
+  }
+
+  void erase(iterator pos) { tree_type::erase(pos); }
+  void swap(flat_set &other) { tree_type::swap(other); }
+  void merge(flat_set &other) { tree_type::merge(other, 0); }
+
+  /* Lookup */
+  iterator find(const key_type &key) const { return tree_type::find(key); }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator find(const K &key) const {
+    return tree_type::find(key);
+  }
+  bool contains(const key_type &key) const {
+    return tree_type::contains(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  bool contains(const K &key) const {
+    return tree_type::contains(key);
+  }
+  size_type count(const key_type &key) const { return tree_type::count(key); }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count(const K &key) const {
+    return tree_type::count(key);
+  }
+  std::pair<iterator, iterator> equal_range(const key_type &key) const {
+    return tree_type::equal_range(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K &key) const {
+    return tree_type::equal_range(key);
+  }
+  iterator lower_bound(const key_type &key) const {
+    return tree_type::lower_bound(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator lower_bound(const K &key) const {
+    return tree_type::lower_bound(key);
+  }
+  iterator upper_bound(const key_type &key) const {
+    return tree_type::upper_bound(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator upper_bound(const K &key) const {
+    return tree_type::upper_bound(key);
+  }
+
+  key_compare key_comp() const { return tree_type::key_comp(); }
+
+  using tree_type::CheckBalance;
+
+  /*Part3*/
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    std::initializer_list<value_type> items{std::forward<Args>(args)...};
+    std::vector<std::pair<iterator, bool>> result;
+    for (auto &n : items) {
+      result.push_back(insert(n));
+    }
+    // an insert may move the values earlier iterators pointed to, so they
+    // are looked up once everything is in
+    auto item = items.begin();
+    for (auto &entry : result) entry.first = find(*item++);
+    return result;
+  }
+};  // class flat_set
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_FLAT_SET_H
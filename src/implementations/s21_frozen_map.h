@@ -0,0 +1,76 @@
+#ifndef SRC_IMPLEMENTATIONS_s_FROZEN_MAP_H
+#define SRC_IMPLEMENTATIONS_s_FROZEN_MAP_H
+
+#include <stdexcept>
+
+#include "frozen_tree.h"
+
+namespace s21 {
+// The read-only snapshot made by map::freeze
+template <typename Key = int, typename T = int,
+          typename Compare = std::less<Key>>
+class frozen_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using key_compare = Compare;
+  using value_type = std::pair<key_type, mapped_type>;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+  using tree_type =
+      s21::FrozenTree<key_type, value_type, s21::KeySelectFirst<value_type>,
+                      Compare>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = size_t;
+
+  frozen_map() : tree_() {}
+
+  // count pairs of a sequence sorted by key, copied in O(n)
+  template <class Iterator>
+  frozen_map(Iterator first, size_type count,
+             const key_compare &compare = key_compare())
+      : tree_(first, count, compare) {}
+
+  // Element access
+  const T &at(const Key &key) const {
+    iterator i = find(key);
+    if (i == end()) {
+      throw std::invalid_argument("\"s_frozen_map::at\" key not found");
+    }
+    return i->second;
+  }
+
+  // iterators
+  iterator begin() const { return tree_.begin(); }
+
+  iterator end() const { return tree_.end(); }
+
+  // Capacity
+  bool empty() const { return tree_.empty(); }
+
+  size_type size() const { return tree_.size(); }
+
+  // Lookup
+  bool contains(const Key &key) const { return tree_.contains(key); }
+
+  iterator find(const Key &key) const { return tree_.find(key); }
+
+  size_type count(const Key &key) const { return tree_.count(key); }
+
+  std::pair<iterator, iterator> equal_range(const Key &key) const {
+    return tree_.equal_range(key);
+  }
+
+  iterator lower_bound(const Key &key) const { return tree_.lower_bound(key); }
+
+  iterator upper_bound(const Key &key) const { return tree_.upper_bound(key); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+ private:
+  tree_type tree_;
+};
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_FROZEN_MAP_H
@@ -0,0 +1,60 @@
+#ifndef SRC_IMPLEMENTATIONS_s_FROZEN_SET_H
+#define SRC_IMPLEMENTATIONS_s_FROZEN_SET_H
+
+#include "frozen_tree.h"
+
+namespace s21 {
+// The read-only snapshot made by set::freeze and multiset::freeze. It
+// shares nothing with its source, so the source may change or go away.
+template <typename Key, typename Compare = std::less<Key>>
+class frozen_set {
+ public:
+  using key_type = Key;
+  using key_compare = Compare;
+  using value_type = Key;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using tree_type = s21::FrozenTree<Key, Key, s21::KeyIdentity<Key>, Compare>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+
+  frozen_set() : tree_() {}
+
+  // count values of a sorted sequence, copied in O(n)
+  template <class Iterator>
+  frozen_set(Iterator first, size_type count,
+             const key_compare &compare = key_compare())
+      : tree_(first, count, compare) {}
+
+  /* Iterators */
+  iterator begin() const { return tree_.begin(); }
+  iterator end() const { return tree_.end(); }
+
+  /* Capacity */
+  bool empty() const { return tree_.empty(); }
+  size_type size() const { return tree_.size(); }
+
+  /* Lookup */
+  iterator find(const key_type &key) const { return tree_.find(key); }
+  bool contains(const key_type &key) const { return tree_.contains(key); }
+  size_type count(const key_type &key) const { return tree_.count(key); }
+  std::pair<iterator, iterator> equal_range(const key_type &key) const {
+    return tree_.equal_range(key);
+  }
+  iterator lower_bound(const key_type &key) const {
+    return tree_.lower_bound(key);
+  }
+  iterator upper_bound(const key_type &key) const {
+    return tree_.upper_bound(key);
+  }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+ private:
+  tree_type tree_;
+};  // class frozen_set
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_FROZEN_SET_H
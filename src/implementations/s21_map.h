@@ -1,43 +1,49 @@
 #ifndef SRC_IMPLEMENTATIONS_MAP_s_MAP_H
 #define SRC_IMPLEMENTATIONS_MAP_s_MAP_H
 
+#include <tuple>
+
+#include "s_frozen_map.h"
 #include "s_vector.h"
 #include "tree.h"
 
 namespace s21 {
-template <typename Key = int, typename T = int>
+template <typename Key = int, typename T = int,
+          typename Compare = std::less<Key>, bool Ranked = false>
 class map {
  public:
   // Member type
   using key_type = Key;
   using mapped_type = T;
+  using key_compare = Compare;
   using value_type = std::pair<key_type, mapped_type>;
   using reference = value_type &;
   using const_reference = const value_type &;
-  using iterator = typename RBtree<value_type>::TreeIterator<value_type>;
-  using const_iterator = typename RBtree<key_type>::ConstTreeIterator<key_type>;
+  using tree_type =
+      s21::RBtree<key_type, value_type, s21::KeySelectFirst<value_type>,
+                  Compare, Ranked>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
   using size_type = size_t;
 
   // Member functions
   map() : tree_(){};
 
-  map(std::initializer_list<value_type> const &items) : tree_(items, false) {
-    for (const value_type &item : items) {
-      tree_.insert(item, 0);
-    }
-  }
+  explicit map(const key_compare &compare) : tree_(compare) {}
+
+  map(std::initializer_list<value_type> const &items) : tree_(items, false) {}
+
+  template <class Iterator>
+  map(Iterator first, Iterator last) : tree_(first, last, false) {}
 
   map(const map &m) : tree_(m.tree_) {}
 
   map(map &&m) : tree_() { tree_.swap(m.tree_); }
 
-  ~map() { tree_.clear(); }
+  ~map() = default;
 
-  map &operator=(map &m) {
-    this->clear();
-    for (auto it = m.begin(); it != m.end(); it++) {
-      this->tree_.insert(*it, 0);
-    }
+  map &operator=(const map &m) {
+    tree_ = m.tree_;
     return *this;
   }
 
@@ -49,29 +55,24 @@ class map {
 
   // Element access
   T &at(const Key &key) {
-    for (auto i = begin(); i != end(); i++) {
-      if (key == i->first) {
-        return i->second;
-      }
+    iterator i = find(key);
+    if (i == end()) {
+      throw std::invalid_argument("\"s_map::at\" thrown in the test body.");
     }
-    throw std::invalid_argument("\"s_map::at\" thrown in the test body.");
+    return i->second;
   }
 
-  T &operator[](const Key &key) {
-    if (size() == 0) {
-      auto ret = tree_.insert(std::pair(key, NULL), 0);
-      return ret.first->second;
-    }
-    auto i = begin();
-    for (; i != end(); ++i) {
-      if (i->first == key) {
-        return i->second;
-      }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  T &at(const K &key) {
+    iterator i = find(key);
+    if (i == end()) {
+      throw std::invalid_argument("\"s_map::at\" thrown in the test body.");
     }
-    auto ret = tree_.insert(std::pair(key, NULL), 0);
-    return ret.first->second;
+    return i->second;
   }
 
+  T &operator[](const Key &key) { return try_emplace(key).first->second; }
+
   // iterators
   iterator begin() { return tree_.begin(); }
 
@@ -84,70 +85,172 @@ class map {
 
   size_type max_size() const noexcept { return tree_.max_size(); }
 
+  void reserve(size_type count) { tree_.reserve(count); }
+
+  size_type capacity() const { return tree_.capacity(); }
+
   // Modifiers
   void clear() { this->tree_.clear(); }
 
-  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
-    if (size() == 0) {
-      tree_.insert(std::pair(key, obj), 0);
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return tree_.insert(value, 0);
+  }
 
-      return std::pair(begin(), 1);
-    }
-    for (auto i = begin(); i != end(); i++) {
-      if (i->first == key) {
-        return std::pair(i, 0);
-      }
-    }
-    tree_.insert(std::pair(key, obj), 0);
-    auto i = begin();
-    for (; i != end(); i++) {
-      if (i->first == key) {
-        break;
-      }
-    }
-    return std::pair(i, 1);
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    return tree_.try_emplace(key, key, obj);
   }
 
   std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj) {
-    for (auto i = begin(); i != end(); i++) {
-      if (i->first == key) {
-        i->second = obj;
-        return std::pair(i, 0);
-      }
-    }
-    tree_.insert(std::pair(key, obj), 0);
-    auto i = begin();
-    for (; i != end(); i++) {
-      if (i->first == key) {
-        break;
-      }
-    }
-    return std::pair(i, 1);
+    std::pair<iterator, bool> result{tree_.try_emplace(key, key, obj)};
+    if (!result.second) result.first->second = obj;
+
+    return result;
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return tree_.emplace(0, std::forward<Args>(args)...);
+  }
+
+  iterator insert(iterator hint, const value_type &value) {
+    return tree_.insert(hint, value, 0).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator hint, Args &&...args) {
+    return tree_.emplace_hint(hint, 0, std::forward<Args>(args)...).first;
+  }
+
+  // the mapped value is built from args only when the key is new
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return tree_.try_emplace(
+        key, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  // replaces the contents in O(n), the range must be sorted by key
+  template <class Iterator>
+  void build_from_sorted(Iterator first, Iterator last) {
+    tree_.build_from_sorted(first, last, false);
+  }
+
+  // a map of an unsorted range, sorted and built on up to threads threads
+  // (0: one per hardware thread); of pairs with equal keys the first one
+  // is kept
+  template <class Iterator>
+  static map from_unsorted(Iterator first, Iterator last,
+                           size_type threads = 0) {
+    map result;
+    result.tree_.build_from_unsorted(first, last, false, threads);
+    return result;
   }
 
   void erase(iterator pos) { tree_.erase(pos); }
 
   void swap(map &other) { tree_.swap(other.tree_); }
 
-  void merge(map &other) {
-    for (auto i = other.begin(); i != other.end(); i++) {
-      if (!(contains(i->first))) {
-        tree_.insert((*i), 0);
-        other.erase(i);
-      }
-    }
+  // see set::merge
+  void merge(map &other) { tree_.merge(other.tree_, 0); }
+
+  // set algebra on the keys in place, the mapped values of this map win;
+  // see set::unite
+  void unite(map &&other, size_type threads = 0) {
+    tree_.unite(std::move(other.tree_), false, threads);
+  }
+  void unite(const map &other, size_type threads = 0) {
+    tree_.unite(other.tree_, false, threads);
+  }
+  void intersect(const map &other, size_type threads = 0) {
+    tree_.intersect(other.tree_, false, threads);
+  }
+  void subtract(const map &other, size_type threads = 0) {
+    tree_.subtract(other.tree_, false, threads);
   }
 
   // Lookup
-  bool contains(const Key &key) {
-    for (auto i = begin(); i != end(); i++) {
-      if (i->first == key) {
-        return true;
-      }
-    }
-    return false;
+  bool contains(const Key &key) { return tree_.contains(key); }
+
+  // lookup by any type the comparator accepts, without a temporary key
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  bool contains(const K &key) {
+    return tree_.contains(key);
   }
 
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  size_type count(const Key &key) const { return tree_.count(key); }
+
+  std::pair<iterator, iterator> equal_range(const Key &key) const {
+    return tree_.equal_range(key);
+  }
+
+  iterator lower_bound(const Key &key) const { return tree_.lower_bound(key); }
+
+  iterator upper_bound(const Key &key) const { return tree_.upper_bound(key); }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count(const K &key) const {
+    return tree_.count(key);
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K &key) const {
+    return tree_.equal_range(key);
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator lower_bound(const K &key) const {
+    return tree_.lower_bound(key);
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator upper_bound(const K &key) const {
+    return tree_.upper_bound(key);
+  }
+
+  // Order statistics, ranked maps only
+  iterator nth(size_type k) { return tree_.nth(k); }
+
+  size_type rank(const Key &key) const { return tree_.rank(key); }
+
+  size_type count_range(const Key &low, const Key &high) const {
+    return tree_.count_range(low, high);
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type rank(const K &key) const {
+    return tree_.rank(key);
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count_range(const K &low, const K &high) const {
+    return tree_.count_range(low, high);
+  }
+
+  // an immutable copy built in O(n) for fast lookups, see frozen_tree.h
+  frozen_map<Key, T, Compare> freeze() const {
+    return frozen_map<Key, T, Compare>(tree_.begin(), tree_.size(),
+                                       key_comp());
+  }
+
+  // calls f(pair) for every pair on up to threads threads (0: one per
+  // hardware thread), see RBtree::parallel_for_each; f must be thread safe
+  template <class Function>
+  void parallel_for_each(Function f, size_type threads = 0) const {
+    tree_.parallel_for_each(f, threads);
+  }
+
+  // an ordered fold of the pairs, see RBtree::parallel_reduce
+  template <class Result, class Accumulate, class Combine>
+  Result parallel_reduce(Result identity, Accumulate accumulate,
+                         Combine combine, size_type threads = 0) const {
+    return tree_.parallel_reduce(std::move(identity), accumulate, combine,
+                                 threads);
+  }
+
+  bool CheckBalance() const { return tree_.CheckBalance(); }
+
   // part3*
   template <typename... key_type, typename... mapped_type>
   std::vector<std::pair<iterator, bool>> insert_many(
@@ -160,17 +263,81 @@ class map {
   }
 
   // other function
-  iterator find(key_type key) {
-    for (auto i = begin(); i != end(); i++) {
-      if (i->first == key) {
-        return i;
-      }
-    }
+  iterator find(const Key &key) { return tree_.find(key); }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator find(const K &key) {
+    return tree_.find(key);
   }
 
  private:
-  s21::RBtree<std::pair<key_type, mapped_type>> tree_;
+  tree_type tree_;
 };
+
+// the set algebra of <algorithm> on the keys of whole maps, the pairs of
+// a win; see set_union
+template <typename Key, typename T, typename Compare, bool Ranked>
+map<Key, T, Compare, Ranked> set_union(const map<Key, T, Compare, Ranked> &a,
+                                       const map<Key, T, Compare, Ranked> &b,
+                                       size_t threads = 0) {
+  map<Key, T, Compare, Ranked> result(a);
+  result.unite(b, threads);
+  return result;
+}
+
+template <typename Key, typename T, typename Compare, bool Ranked>
+map<Key, T, Compare, Ranked> set_union(map<Key, T, Compare, Ranked> &&a,
+                                       const map<Key, T, Compare, Ranked> &b,
+                                       size_t threads = 0) {
+  a.unite(b, threads);
+  return std::move(a);
+}
+
+template <typename Key, typename T, typename Compare, bool Ranked>
+map<Key, T, Compare, Ranked> set_union(map<Key, T, Compare, Ranked> &&a,
+                                       map<Key, T, Compare, Ranked> &&b,
+                                       size_t threads = 0) {
+  a.unite(std::move(b), threads);
+  return std::move(a);
+}
+
+template <typename Key, typename T, typename Compare, bool Ranked>
+map<Key, T, Compare, Ranked> set_intersection(
+    const map<Key, T, Compare, Ranked> &a,
+    const map<Key, T, Compare, Ranked> &b, size_t threads = 0) {
+  map<Key, T, Compare, Ranked> result(a);
+  result.intersect(b, threads);
+  return result;
+}
+
+template <typename Key, typename T, typename Compare, bool Ranked>
+map<Key, T, Compare, Ranked> set_intersection(
+    map<Key, T, Compare, Ranked> &&a, const map<Key, T, Compare, Ranked> &b,
+    size_t threads = 0) {
+  a.intersect(b, threads);
+  return std::move(a);
+}
+
+template <typename Key, typename T, typename Compare, bool Ranked>
+map<Key, T, Compare, Ranked> set_difference(
+    const map<Key, T, Compare, Ranked> &a,
+    const map<Key, T, Compare, Ranked> &b, size_t threads = 0) {
+  map<Key, T, Compare, Ranked> result(a);
+  result.subtract(b, threads);
+  return result;
+}
+
+template <typename Key, typename T, typename Compare, bool Ranked>
+map<Key, T, Compare, Ranked> set_difference(
+    map<Key, T, Compare, Ranked> &&a, const map<Key, T, Compare, Ranked> &b,
+    size_t threads = 0) {
+  a.subtract(b, threads);
+  return std::move(a);
+}
+
+// a map that also answers nth, rank and count_range in O(log n)
+template <typename Key, typename T, typename Compare = std::less<Key>>
+using ranked_map = map<Key, T, Compare, true>;
 }  // namespace s21
 
 #endif  // SRC_IMPLEMENTATIONS_MAP_s_MAP_H
@@ -5,65 +5,100 @@
 #include "s_vector.h"
 
 namespace s21 {
-template <typename Key>
-class multiset : public s21::set<Key> {
+template <typename Key, typename Compare = std::less<Key>, bool Ranked = false>
+class multiset : public s21::set<Key, Compare, Ranked> {
  public:
   using key_type = Key;
+  using key_compare = Compare;
   using value_type = Key;
   using reference = value_type&;
   using const_reference = const value_type&;
   using size_type = size_t;
-  using iterator = typename RBtree<key_type>::TreeIterator<key_type>;
-  using const_iterator = typename RBtree<key_type>::ConstTreeIterator<key_type>;
+  using tree_type = typename s21::set<Key, Compare, Ranked>::tree_type;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
 
-  multiset() : s21::set<key_type>() {}
+  multiset() : s21::set<Key, Compare, Ranked>() {}
+  explicit multiset(const key_compare& compare)
+      : s21::set<Key, Compare, Ranked>(compare) {}
 
   multiset(std::initializer_list<value_type> const& items) {
-    for (const value_type& item : items) s21::RBtree<key_type>::insert(item, 1);
+    tree_type tree(items, 1);
+    tree_type::swap(tree);
   }
 
-  multiset(const multiset& ms) : s21::set<key_type>(ms) {}
-  multiset(multiset&& ms) : s21::set<key_type>(std::move(ms)) {}
+  template <class Iterator>
+  multiset(Iterator first, Iterator last) {
+    tree_type items(first, last, 1);
+    tree_type::swap(items);
+  }
+
+  multiset(const multiset& ms) : s21::set<Key, Compare, Ranked>(ms) {}
+  multiset(multiset&& ms) : s21::set<Key, Compare, Ranked>(std::move(ms)) {}
   ~multiset() = default;
 
   multiset& operator=(multiset&& ms) {
-    s21::RBtree<key_type>::operator=(std::move(ms));
+    tree_type::operator=(std::move(ms));
     return *this;
   }
 
   multiset& operator=(const multiset& ms) {
-    s21::RBtree<key_type>::operator=(ms);
+    tree_type::operator=(ms);
     return *this;
   }
 
   /* Modifiers */
   std::pair<iterator, bool> insert(const value_type& value) {
-    return s21::RBtree<key_type>::insert(value, 1);
+    return tree_type::insert(value, 1);
   }
 
-  void merge(multiset& other) { s21::RBtree<key_type>::merge(other, 1); }
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree_type::emplace(1, std::forward<Args>(args)...);
+  }
 
-  /* Lookup */
-  size_type count(const key_type& key) {
-    size_type count = 0;
-    for (auto it = s21::set<key_type>::begin(); it != s21::set<key_type>::end();
-         ++it) {
-      if (*it == key) ++count;
-    }
-    return count;
+  iterator insert(iterator hint, const value_type& value) {
+    return tree_type::insert(hint, value, 1).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator hint, Args&&... args) {
+    return tree_type::emplace_hint(hint, 1, std::forward<Args>(args)...).first;
   }
 
-  std::pair<iterator, iterator> equal_range(const key_type& key) {
-    iterator first = s21::set<key_type>::find(key);
-    size_type count{this->count(key)};
-    iterator last{first};
-    while (count--) ++last;
+  // replaces the contents in O(n), the range must be sorted
+  template <class Iterator>
+  void build_from_sorted(Iterator first, Iterator last) {
+    tree_type::build_from_sorted(first, last, 1);
+  }
 
-    return std::pair<iterator, iterator>(first, last);
+  // a multiset of an unsorted range built on up to threads threads (0: one
+  // per hardware thread); equal keys keep the order of the range
+  template <class Iterator>
+  static multiset from_unsorted(Iterator first, Iterator last,
+                                size_type threads = 0) {
+    multiset result;
+    result.tree_type::build_from_unsorted(first, last, 1, threads);
+    return result;
   }
 
-  iterator lower_bound(const key_type& key) { return equal_range(key).first; }
-  iterator upper_bound(const key_type& key) { return equal_range(key).second; }
+  // see set::merge
+  void merge(multiset& other) { tree_type::merge(other, 1); }
+
+  // set algebra in place with the multiplicities of <algorithm>, see
+  // set::unite
+  void unite(multiset&& other, size_type threads = 0) {
+    tree_type::unite(std::move(other), 1, threads);
+  }
+  void unite(const multiset& other, size_type threads = 0) {
+    tree_type::unite(other, 1, threads);
+  }
+  void intersect(const multiset& other, size_type threads = 0) {
+    tree_type::intersect(other, 1, threads);
+  }
+  void subtract(const multiset& other, size_type threads = 0) {
+    tree_type::subtract(other, 1, threads);
+  }
 
   /*Part3*/
   template <class... Args>
@@ -76,6 +111,70 @@ class multiset : public s21::set<Key> {
     return result;
   }
 };
+
+// the set algebra of <algorithm> on whole multisets, see set_union
+template <typename Key, typename Compare, bool Ranked>
+multiset<Key, Compare, Ranked> set_union(
+    const multiset<Key, Compare, Ranked>& a,
+    const multiset<Key, Compare, Ranked>& b, size_t threads = 0) {
+  multiset<Key, Compare, Ranked> result(a);
+  result.unite(b, threads);
+  return result;
+}
+
+template <typename Key, typename Compare, bool Ranked>
+multiset<Key, Compare, Ranked> set_union(
+    multiset<Key, Compare, Ranked>&& a, const multiset<Key, Compare, Ranked>& b,
+    size_t threads = 0) {
+  a.unite(b, threads);
+  return std::move(a);
+}
+
+template <typename Key, typename Compare, bool Ranked>
+multiset<Key, Compare, Ranked> set_union(multiset<Key, Compare, Ranked>&& a,
+                                         multiset<Key, Compare, Ranked>&& b,
+                                         size_t threads = 0) {
+  a.unite(std::move(b), threads);
+  return std::move(a);
+}
+
+template <typename Key, typename Compare, bool Ranked>
+multiset<Key, Compare, Ranked> set_intersection(
+    const multiset<Key, Compare, Ranked>& a,
+    const multiset<Key, Compare, Ranked>& b, size_t threads = 0) {
+  multiset<Key, Compare, Ranked> result(a);
+  result.intersect(b, threads);
+  return result;
+}
+
+template <typename Key, typename Compare, bool Ranked>
+multiset<Key, Compare, Ranked> set_intersection(
+    multiset<Key, Compare, Ranked>&& a, const multiset<Key, Compare, Ranked>& b,
+    size_t threads = 0) {
+  a.intersect(b, threads);
+  return std::move(a);
+}
+
+template <typename Key, typename Compare, bool Ranked>
+multiset<Key, Compare, Ranked> set_difference(
+    const multiset<Key, Compare, Ranked>& a,
+    const multiset<Key, Compare, Ranked>& b, size_t threads = 0) {
+  multiset<Key, Compare, Ranked> result(a);
+  result.subtract(b, threads);
+  return result;
+}
+
+template <typename Key, typename Compare, bool Ranked>
+multiset<Key, Compare, Ranked> set_difference(
+    multiset<Key, Compare, Ranked>&& a, const multiset<Key, Compare, Ranked>& b,
+    size_t threads = 0) {
+  a.subtract(b, threads);
+  return std::move(a);
+}
+
+// a multiset that also answers nth, rank and count_range in O(log n)
+template <typename Key, typename Compare = std::less<Key>>
+using ranked_multiset = multiset<Key, Compare, true>;
 }  // namespace s21
 
 #endif  // SRC_IMPLEMENTATIONS_s_MULTISET_H
@@ -0,0 +1,107 @@
+#ifndef SRC_IMPLEMENTATIONS_s_PERSISTENT_SET_H
+#define SRC_IMPLEMENTATIONS_s_PERSISTENT_SET_H
+
+#include "persistent_tree.h"
+#include "s_vector.h"
+
+namespace s21 {
+// s21::set with O(1) snapshots: one writer updates it while any number of
+// readers take snapshot() and walk or search their copy without locks,
+// see persistent_tree.h. Values are immutable; an iterator keeps its
+// version alive and stays valid across later updates.
+template <typename Key, typename Compare = std::less<Key>>
+class persistent_set
+    : protected s21::PersistentTree<Key, Key, s21::KeyIdentity<Key>,
+                                    Compare> {
+ public:
+  using key_type = Key;
+  using key_compare = Compare;
+  using tree_type =
+      s21::PersistentTree<Key, Key, s21::KeyIdentity<Key>, Compare>;
+  using value_type = Key;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+
+  persistent_set() : tree_type() {}
+  explicit persistent_set(const key_compare &compare) : tree_type(compare) {}
+  persistent_set(std::initializer_list<value_type> const &items)
+      : persistent_set(items.begin(), items.end()) {}
+  template <class Iterator>
+  persistent_set(Iterator first, Iterator last) : tree_type() {
+    for (; first != last; ++first) insert(*first);
+  }
+  // O(1), the copy shares every node with s
+  persistent_set(const persistent_set &s) : tree_type(s) {}
+  ~persistent_set() = default;
+
+  persistent_set &operator=(const persistent_set &s) {
+    tree_type::operator=(s);
+    return *this;
+  }
+
+  // the current contents as an independent set, in O(1)
+  persistent_set snapshot() const { return *this; }
+
+  /* Iterators */
+  iterator begin() const { return tree_type::begin(); }
+  iterator end() const { return tree_type::end(); }
+
+  /* Capacity */
+  bool empty() const { return tree_type::empty(); }
+  size_type size() const { return tree_type::size(); }
+  size_type max_size() const { return tree_type::max_size(); }
+
+  /* Modifiers */
+  void clear() { tree_type::clear(); }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return tree_type::insert(value, 0);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return tree_type::emplace(0, std::forward<Args>(args)...);
+  }
+
+  void erase(iterator pos) { tree_type::erase(*pos); }
+  bool erase(const key_type &key) { return tree_type::erase(key); }
+  void swap(persistent_set &other) { tree_type::swap(other); }
+
+  /* Lookup */
+  iterator find(const key_type &key) const { return tree_type::find(key); }
+  bool contains(const key_type &key) const {
+    return tree_type::contains(key);
+  }
+  size_type count(const key_type &key) const { return tree_type::count(key); }
+  std::pair<iterator, iterator> equal_range(const key_type &key) const {
+    return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+  iterator lower_bound(const key_type &key) const {
+    return tree_type::lower_bound(key);
+  }
+  iterator upper_bound(const key_type &key) const {
+    return tree_type::upper_bound(key);
+  }
+
+  key_compare key_comp() const { return tree_type::key_comp(); }
+
+  using tree_type::CheckBalance;
+
+  /*Part3*/
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    std::initializer_list<value_type> items{std::forward<Args>(args)...};
+    std::vector<std::pair<iterator, bool>> result;
+    for (auto &n : items) {
+      result.push_back(insert(n));
+    }
+    return result;
+  }
+};  // class persistent_set
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_PERSISTENT_SET_H
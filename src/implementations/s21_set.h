@@ -1,70 +1,199 @@
 #ifndef SRC_IMPLEMENTATIONS_s_SET_H
 #define SRC_IMPLEMENTATIONS_s_SET_H
 
+#include "s_frozen_set.h"
 #include "s_vector.h"
 #include "tree.h"
 
 namespace s21 {
-template <typename Key>
-class set : protected s21::RBtree<Key> {
+template <typename Key, typename Compare = std::less<Key>, bool Ranked = false>
+class set : protected s21::RBtree<Key, Key, s21::KeyIdentity<Key>, Compare,
+                                  Ranked> {
  public:
   using key_type = Key;
-  using value_type =
-      typename RBtree<key_type>::TreeIterator<key_type>::value_type;
-  using reference =
-      typename RBtree<key_type>::TreeIterator<key_type>::reference;
-  using const_reference = typename RBtree<key_type>::const_reference;
+  using key_compare = Compare;
+  using tree_type =
+      s21::RBtree<Key, Key, s21::KeyIdentity<Key>, Compare, Ranked>;
+  using value_type = typename tree_type::iterator::value_type;
+  using reference = typename tree_type::iterator::reference;
+  using const_reference = typename tree_type::const_reference;
   using size_type = size_t;
-  using iterator = typename RBtree<key_type>::TreeIterator<key_type>;
-  using const_iterator = typename RBtree<key_type>::ConstTreeIterator<key_type>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
 
-  set() : s21::RBtree<key_type>() {}
-  set(std::initializer_list<value_type> const &items)
-      : s21::RBtree<key_type>(items, 0) {}
-  set(const set &s) : s21::RBtree<key_type>(s) {}
-  set(set &&s) : s21::RBtree<Key>(std::move(s)) {}
-  ~set() { s21::RBtree<key_type>::clear(); }
+  set() : tree_type() {}
+  explicit set(const key_compare &compare) : tree_type(compare) {}
+  set(std::initializer_list<value_type> const &items) : tree_type(items, 0) {}
+  template <class Iterator>
+  set(Iterator first, Iterator last) : tree_type(first, last, 0) {}
+  set(const set &s) : tree_type(s) {}
+  set(set &&s) : tree_type(std::move(s)) {}
+  ~set() = default;
 
   // operator assignment move
   set &operator=(set &&s) {
-    s21::RBtree<Key>::operator=(std::move(s));
+    tree_type::operator=(std::move(s));
     return *this;
   }
 
   // operator assignment copy
   set &operator=(const set &s) {
-    s21::RBtree<key_type>::operator=(s);
+    tree_type::operator=(s);
     return *this;
   }
 
   /* Iterators */
-  iterator begin() { return s21::RBtree<key_type>::begin(); }
-  iterator end() { return s21::RBtree<key_type>::end(); }
+  iterator begin() { return tree_type::begin(); }
+  iterator end() { return tree_type::end(); }
 
   /* Capacity */
-  bool empty() const { return s21::RBtree<key_type>::empty(); }
-  size_type size() { return s21::RBtree<key_type>::size(); }
-  size_type max_size() { return s21::RBtree<key_type>::max_size(); }
+  bool empty() const { return tree_type::empty(); }
+  size_type size() { return tree_type::size(); }
+  size_type max_size() { return tree_type::max_size(); }
+  void reserve(size_type count) { tree_type::reserve(count); }
+  size_type capacity() const { return tree_type::capacity(); }
 
   /* Modifiers */
-  void clear() { s21::RBtree<key_type>::clear(); }
+  void clear() { tree_type::clear(); }
 
   std::pair<iterator, bool> insert(const value_type &value) {
-    return s21::RBtree<key_type>::insert(value, 0);
+    return tree_type::insert(value, 0);
   }
 
-  void erase(iterator pos) { s21::RBtree<key_type>::erase(pos); }
-  void swap(set &other) { s21::RBtree<key_type>::swap(other); }
-  void merge(set &other) { s21::RBtree<key_type>::merge(other, 0); }
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return tree_type::emplace(0, std::forward<Args>(args)...);
+  }
+
+  iterator insert(iterator hint, const value_type &value) {
+    return tree_type::insert(hint, value, 0).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator hint, Args &&...args) {
+    return tree_type::emplace_hint(hint, 0, std::forward<Args>(args)...).first;
+  }
+
+  // replaces the contents in O(n), the range must be sorted
+  template <class Iterator>
+  void build_from_sorted(Iterator first, Iterator last) {
+    tree_type::build_from_sorted(first, last, 0);
+  }
+
+  // a set of an unsorted range, sorted and built on up to threads threads
+  // (0: one per hardware thread); of equal keys the first one is kept
+  template <class Iterator>
+  static set from_unsorted(Iterator first, Iterator last,
+                           size_type threads = 0) {
+    set result;
+    result.tree_type::build_from_unsorted(first, last, 0, threads);
+    return result;
+  }
+
+  void erase(iterator pos) { tree_type::erase(pos); }
+  void swap(set &other) { tree_type::swap(other); }
+  // splices the nodes over without copying, iterators to them stay valid;
+  // both sets may still be used from different threads afterwards
+  void merge(set &other) { tree_type::merge(other, 0); }
+
+  // set algebra in place by split and join, O(m log(n/m + 1)) for sizes
+  // m <= n on up to threads threads (0: one per hardware thread). A union
+  // with an rvalue takes over its nodes and leaves it empty, one with an
+  // lvalue copies its values.
+  void unite(set &&other, size_type threads = 0) {
+    tree_type::unite(std::move(other), 0, threads);
+  }
+  void unite(const set &other, size_type threads = 0) {
+    tree_type::unite(other, 0, threads);
+  }
+  void intersect(const set &other, size_type threads = 0) {
+    tree_type::intersect(other, 0, threads);
+  }
+  void subtract(const set &other, size_type threads = 0) {
+    tree_type::subtract(other, 0, threads);
+  }
 
   /* Lookup */
-  iterator find(const key_type &key) {
-    return s21::RBtree<key_type>::find(key);
-  };
-  bool contains(const key_type &key) {
-    return s21::RBtree<key_type>::contains(key);
+  iterator find(const key_type &key) { return tree_type::find(key); }
+  bool contains(const key_type &key) { return tree_type::contains(key); }
+
+  // lookup by any type the comparator accepts, without a temporary key
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator find(const K &key) {
+    return tree_type::find(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  bool contains(const K &key) {
+    return tree_type::contains(key);
+  }
+
+  key_compare key_comp() const { return tree_type::key_comp(); }
+
+  size_type count(const key_type &key) const { return tree_type::count(key); }
+  std::pair<iterator, iterator> equal_range(const key_type &key) const {
+    return tree_type::equal_range(key);
+  }
+  iterator lower_bound(const key_type &key) const {
+    return tree_type::lower_bound(key);
+  }
+  iterator upper_bound(const key_type &key) const {
+    return tree_type::upper_bound(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count(const K &key) const {
+    return tree_type::count(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K &key) const {
+    return tree_type::equal_range(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator lower_bound(const K &key) const {
+    return tree_type::lower_bound(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator upper_bound(const K &key) const {
+    return tree_type::upper_bound(key);
+  }
+
+  /* Order statistics, ranked sets only */
+  iterator nth(size_type k) { return tree_type::nth(k); }
+  size_type rank(const key_type &key) const { return tree_type::rank(key); }
+  size_type count_range(const key_type &low, const key_type &high) const {
+    return tree_type::count_range(low, high);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type rank(const K &key) const {
+    return tree_type::rank(key);
+  }
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count_range(const K &low, const K &high) const {
+    return tree_type::count_range(low, high);
+  }
+
+  // an immutable copy built in O(n) for fast lookups, see frozen_tree.h
+  frozen_set<Key, Compare> freeze() const {
+    return frozen_set<Key, Compare>(tree_type::begin(), tree_type::size(),
+                                    key_comp());
+  }
+
+  // calls f(key) for every key on up to threads threads (0: one per
+  // hardware thread), see RBtree::parallel_for_each; f must be thread safe
+  template <class Function>
+  void parallel_for_each(Function f, size_type threads = 0) const {
+    tree_type::parallel_for_each(f, threads);
+  }
+
+  // an ordered fold of the keys, see RBtree::parallel_reduce
+  template <class Result, class Accumulate, class Combine>
+  Result parallel_reduce(Result identity, Accumulate accumulate,
+                         Combine combine, size_type threads = 0) const {
+    return tree_type::parallel_reduce(std::move(identity), accumulate,
+                                      combine, threads);
   }
 
+  using tree_type::CheckBalance;
+
   /*Part3*/
   template <class... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
@@ -77,6 +206,72 @@ class set : protected s21::RBtree<Key> {
   }
 };  // class set
 
+// the set algebra of <algorithm> on whole sets. The result starts as a
+// copy of a, or takes a over when it is an rvalue; b is only read, except
+// that a union takes over the nodes of an rvalue b. See set::unite.
+template <typename Key, typename Compare, bool Ranked>
+set<Key, Compare, Ranked> set_union(const set<Key, Compare, Ranked> &a,
+                                    const set<Key, Compare, Ranked> &b,
+                                    size_t threads = 0) {
+  set<Key, Compare, Ranked> result(a);
+  result.unite(b, threads);
+  return result;
+}
+
+template <typename Key, typename Compare, bool Ranked>
+set<Key, Compare, Ranked> set_union(set<Key, Compare, Ranked> &&a,
+                                    const set<Key, Compare, Ranked> &b,
+                                    size_t threads = 0) {
+  a.unite(b, threads);
+  return std::move(a);
+}
+
+template <typename Key, typename Compare, bool Ranked>
+set<Key, Compare, Ranked> set_union(set<Key, Compare, Ranked> &&a,
+                                    set<Key, Compare, Ranked> &&b,
+                                    size_t threads = 0) {
+  a.unite(std::move(b), threads);
+  return std::move(a);
+}
+
+template <typename Key, typename Compare, bool Ranked>
+set<Key, Compare, Ranked> set_intersection(const set<Key, Compare, Ranked> &a,
+                                           const set<Key, Compare, Ranked> &b,
+                                           size_t threads = 0) {
+  set<Key, Compare, Ranked> result(a);
+  result.intersect(b, threads);
+  return result;
+}
+
+template <typename Key, typename Compare, bool Ranked>
+set<Key, Compare, Ranked> set_intersection(set<Key, Compare, Ranked> &&a,
+                                           const set<Key, Compare, Ranked> &b,
+                                           size_t threads = 0) {
+  a.intersect(b, threads);
+  return std::move(a);
+}
+
+template <typename Key, typename Compare, bool Ranked>
+set<Key, Compare, Ranked> set_difference(const set<Key, Compare, Ranked> &a,
+                                         const set<Key, Compare, Ranked> &b,
+                                         size_t threads = 0) {
+  set<Key, Compare, Ranked> result(a);
+  result.subtract(b, threads);
+  return result;
+}
+
+template <typename Key, typename Compare, bool Ranked>
+set<Key, Compare, Ranked> set_difference(set<Key, Compare, Ranked> &&a,
+                                         const set<Key, Compare, Ranked> &b,
+                                         size_t threads = 0) {
+  a.subtract(b, threads);
+  return std::move(a);
+}
+
+// a set that also answers nth, rank and count_range in O(log n)
+template <typename Key, typename Compare = std::less<Key>>
+using ranked_set = set<Key, Compare, true>;
+
 }  // namespace s21
 
 #endif  // SRC_IMPLEMENTATIONS_s_SET_H
@@ -0,0 +1,198 @@
+#ifndef SRC_IMPLEMENTATIONS_s_UNORDERED_MAP_H
+#define SRC_IMPLEMENTATIONS_s_UNORDERED_MAP_H
+
+#include <stdexcept>
+#include <tuple>
+
+#include "hash_table.h"
+#include "s_vector.h"
+
+namespace s21 {
+// s21::map without the order, on an open-addressing hash table; inserts
+// that rehash invalidate iterators
+template <typename Key = int, typename T = int,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class unordered_map {
+ public:
+  // Member type
+  using key_type = Key;
+  using mapped_type = T;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using value_type = std::pair<key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using table_type =
+      s21::HashTable<key_type, value_type, s21::KeySelectFirst<value_type>,
+                     Hash, KeyEqual>;
+  using iterator = typename table_type::iterator;
+  using const_iterator = typename table_type::const_iterator;
+  using size_type = size_t;
+
+  // Member functions
+  unordered_map() : table_() {}
+
+  explicit unordered_map(const hasher &hash,
+                         const key_equal &equal = key_equal())
+      : table_(hash, equal) {}
+
+  unordered_map(std::initializer_list<value_type> const &items)
+      : table_(items) {}
+
+  template <class Iterator>
+  unordered_map(Iterator first, Iterator last) : table_(first, last) {}
+
+  unordered_map(const unordered_map &m) : table_(m.table_) {}
+
+  unordered_map(unordered_map &&m) : table_() { table_.swap(m.table_); }
+
+  ~unordered_map() = default;
+
+  unordered_map &operator=(const unordered_map &m) {
+    table_ = m.table_;
+    return *this;
+  }
+
+  unordered_map &operator=(unordered_map &&m) {
+    table_.clear();
+    table_.swap(m.table_);
+    return *this;
+  }
+
+  // Element access
+  T &at(const Key &key) {
+    iterator i = find(key);
+    if (i == end()) {
+      throw std::invalid_argument("\"s_unordered_map::at\" key not found");
+    }
+    return i->second;
+  }
+
+  template <class K, class H = Hash, class E = KeyEqual,
+            class = typename H::is_transparent,
+            class = typename E::is_transparent>
+  T &at(const K &key) {
+    iterator i = find(key);
+    if (i == end()) {
+      throw std::invalid_argument("\"s_unordered_map::at\" key not found");
+    }
+    return i->second;
+  }
+
+  T &operator[](const Key &key) { return try_emplace(key).first->second; }
+
+  // iterators
+  iterator begin() { return table_.begin(); }
+
+  iterator end() { return table_.end(); }
+
+  // Capacity
+  bool empty() const { return table_.empty(); }
+
+  size_type size() const { return table_.size(); }
+
+  size_type max_size() const noexcept { return table_.max_size(); }
+
+  void reserve(size_type count) { table_.reserve(count); }
+
+  size_type capacity() const { return table_.capacity(); }
+
+  float load_factor() const { return table_.load_factor(); }
+
+  // Modifiers
+  void clear() { table_.clear(); }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return table_.insert(value);
+  }
+
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    return table_.try_emplace(key, key, obj);
+  }
+
+  std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj) {
+    std::pair<iterator, bool> result{table_.try_emplace(key, key, obj)};
+    if (!result.second) result.first->second = obj;
+
+    return result;
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return table_.emplace(std::forward<Args>(args)...);
+  }
+
+  // the hint is accepted for compatibility with s21::map only
+  iterator insert(iterator, const value_type &value) {
+    return insert(value).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator, Args &&...args) {
+    return emplace(std::forward<Args>(args)...).first;
+  }
+
+  // the mapped value is built from args only when the key is new
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return table_.try_emplace(
+        key, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  void erase(iterator pos) { table_.erase(pos); }
+
+  void swap(unordered_map &other) { table_.swap(other.table_); }
+
+  void merge(unordered_map &other) { table_.merge(other.table_); }
+
+  // Lookup
+  bool contains(const Key &key) const { return table_.contains(key); }
+
+  iterator find(const Key &key) const { return table_.find(key); }
+
+  // lookup by any type that both the hash and the equality accept, without
+  // a temporary key
+  template <class K, class H = Hash, class E = KeyEqual,
+            class = typename H::is_transparent,
+            class = typename E::is_transparent>
+  bool contains(const K &key) const {
+    return table_.contains(key);
+  }
+
+  template <class K, class H = Hash, class E = KeyEqual,
+            class = typename H::is_transparent,
+            class = typename E::is_transparent>
+  iterator find(const K &key) const {
+    return table_.find(key);
+  }
+
+  size_type count(const Key &key) const { return table_.count(key); }
+
+  hasher hash_function() const { return table_.hash_function(); }
+
+  key_equal key_eq() const { return table_.key_eq(); }
+
+  // part3*
+  template <typename... key_type, typename... mapped_type>
+  std::vector<std::pair<iterator, bool>> insert_many(
+      std::pair<key_type, mapped_type> &&...args) {
+    auto items = {args...};
+    std::vector<std::pair<iterator, bool>> ret;
+    for (const auto &arg : items) {
+      ret.push_back(insert(arg.first, arg.second));
+    }
+    // an insert may rehash and free the slots of earlier iterators, so they
+    // are looked up once everything is in
+    auto item = items.begin();
+    for (auto &entry : ret) entry.first = find((item++)->first);
+    return ret;
+  }
+
+ private:
+  table_type table_;
+};
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_UNORDERED_MAP_H
@@ -0,0 +1,130 @@
+#ifndef SRC_IMPLEMENTATIONS_s_UNORDERED_SET_H
+#define SRC_IMPLEMENTATIONS_s_UNORDERED_SET_H
+
+#include "hash_table.h"
+#include "s_vector.h"
+
+namespace s21 {
+// s21::set without the order: point lookups probe an open-addressing hash
+// table, see hash_table.h. Iteration order is unspecified and inserts that
+// rehash invalidate iterators.
+template <typename Key, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class unordered_set
+    : protected s21::HashTable<Key, Key, s21::KeyIdentity<Key>, Hash,
+                               KeyEqual> {
+ public:
+  using key_type = Key;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using table_type =
+      s21::HashTable<Key, Key, s21::KeyIdentity<Key>, Hash, KeyEqual>;
+  using value_type = Key;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using iterator = typename table_type::iterator;
+  using const_iterator = typename table_type::const_iterator;
+
+  unordered_set() : table_type() {}
+  explicit unordered_set(const hasher &hash,
+                         const key_equal &equal = key_equal())
+      : table_type(hash, equal) {}
+  unordered_set(std::initializer_list<value_type> const &items)
+      : table_type(items) {}
+  template <class Iterator>
+  unordered_set(Iterator first, Iterator last) : table_type(first, last) {}
+  unordered_set(const unordered_set &s) : table_type(s) {}
+  unordered_set(unordered_set &&s) : table_type(std::move(s)) {}
+  ~unordered_set() = default;
+
+  unordered_set &operator=(unordered_set &&s) {
+    table_type::operator=(std::move(s));
+    return *this;
+  }
+
+  unordered_set &operator=(const unordered_set &s) {
+    table_type::operator=(s);
+    return *this;
+  }
+
+  /* Iterators */
+  iterator begin() { return table_type::begin(); }
+  iterator end() { return table_type::end(); }
+
+  /* Capacity */
+  bool empty() const { return table_type::empty(); }
+  size_type size() const { return table_type::size(); }
+  size_type max_size() const { return table_type::max_size(); }
+  void reserve(size_type count) { table_type::reserve(count); }
+  size_type capacity() const { return table_type::capacity(); }
+  float load_factor() const { return table_type::load_factor(); }
+
+  /* Modifiers */
+  void clear() { table_type::clear(); }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return table_type::insert(value);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return table_type::emplace(std::forward<Args>(args)...);
+  }
+
+  // the hint is accepted for compatibility with s21::set only
+  iterator insert(iterator, const value_type &value) {
+    return insert(value).first;
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator, Args &&...args) {
+    return emplace(std::forward<Args>(args)...).first;
+  }
+
+  void erase(iterator pos) { table_type::erase(pos); }
+  void swap(unordered_set &other) { table_type::swap(other); }
+  void merge(unordered_set &other) { table_type::merge(other); }
+
+  /* Lookup */
+  iterator find(const key_type &key) { return table_type::find(key); }
+  bool contains(const key_type &key) { return table_type::contains(key); }
+  size_type count(const key_type &key) const { return table_type::count(key); }
+
+  // lookup by any type that both the hash and the equality accept, without
+  // a temporary key
+  template <class K, class H = Hash, class E = KeyEqual,
+            class = typename H::is_transparent,
+            class = typename E::is_transparent>
+  iterator find(const K &key) {
+    return table_type::find(key);
+  }
+  template <class K, class H = Hash, class E = KeyEqual,
+            class = typename H::is_transparent,
+            class = typename E::is_transparent>
+  bool contains(const K &key) {
+    return table_type::contains(key);
+  }
+
+  hasher hash_function() const { return table_type::hash_function(); }
+  key_equal key_eq() const { return table_type::key_eq(); }
+
+  /*Part3*/
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    std::initializer_list<value_type> items{std::forward<Args>(args)...};
+    std::vector<std::pair<iterator, bool>> result;
+    for (auto &n : items) {
+      result.push_back(insert(n));
+    }
+    // an insert may rehash and free the slots of earlier iterators, so they
+    // are looked up once everything is in
+    auto item = items.begin();
+    for (auto &entry : result) entry.first = find(*item++);
+    return result;
+  }
+};  // class unordered_set
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_s_UNORDERED_SET_H
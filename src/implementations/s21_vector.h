@@ -1,6 +1,12 @@
 #ifndef SRC_IMPLEMENTATIONS_s_VECTOR_H
 #define SRC_IMPLEMENTATIONS_s_VECTOR_H
 
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
 namespace s21 {
 
 template <typename T>
@@ -32,10 +38,12 @@ class vector {
   /* Iterators */
   iterator begin();
   iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
 
   /* Capacity */
-  bool empty();
-  size_type size();
+  bool empty() const;
+  size_type size() const;
   size_type max_size();
   void reserve(size_type size);
   size_type capacity();
@@ -12,6 +12,13 @@ vector<T>::~vector() {
 template <typename T>
 vector<T>::vector(vector &&other) : sz{other.sz}, ln{other.ln}, data_{nullptr} {
   std::swap(data_, other.data_);
+  other.sz = other.ln = 0;
+}
+
+template <typename T>
+vector<T>::vector(const vector &other) : sz{other.sz}, ln{other.ln} {
+  data_ = new T[sz];
+  for (size_type i = 0; i < ln; ++i) data_[i] = other.data_[i];
 }
 
 template <typename T>
@@ -59,7 +66,7 @@ typename vector<T>::iterator vector<T>::data() {
 }
 
 template <typename T>
-bool vector<T>::empty() {
+bool vector<T>::empty() const {
   return ln == 0 ? 1 : 0;
 }
 
@@ -69,7 +76,7 @@ typename vector<T>::size_type vector<T>::capacity() {
 }
 
 template <typename T>
-typename vector<T>::size_type vector<T>::size() {
+typename vector<T>::size_type vector<T>::size() const {
   return ln;
 }
 
@@ -83,7 +90,7 @@ void vector<T>::swap(vector<T> &other) {
 template <typename T>
 void vector<T>::shrink() {
   iterator newdata = new T[sz]();
-  for (size_t i{0}; i < ln; ++i) newdata[i] = data_[i];
+  for (size_t i{0}; i < ln; ++i) newdata[i] = std::move(data_[i]);
 
   std::swap(data_, newdata);
   delete[] newdata;
@@ -113,16 +120,16 @@ void vector<T>::reserve(size_type size) {
 
 template <typename T>
 void vector<T>::push_back(T value) {
-  if (ln == sz) reserve(sz * 2);
+  if (ln == sz) reserve(sz ? sz * 2 : 4);
 
-  data_[ln++] = value;
+  data_[ln++] = std::move(value);
 }
 
 template <typename T>
 void vector<T>::pop_back() {
   if (!ln) return;
 
-  data_[--ln] = 0;
+  data_[--ln] = value_type();
 }
 
 template <typename T>
@@ -157,6 +164,16 @@ typename vector<T>::iterator vector<T>::end() {
   return data_ + ln;
 }
 
+template <typename T>
+typename vector<T>::const_iterator vector<T>::begin() const {
+  return data_;
+}
+
+template <typename T>
+typename vector<T>::const_iterator vector<T>::end() const {
+  return data_ + ln;
+}
+
 template <typename T>
 vector<T> &vector<T>::operator=(vector &&other) {
   sz = other.sz;
@@ -164,6 +181,7 @@ vector<T> &vector<T>::operator=(vector &&other) {
   delete[] data_;
   data_ = nullptr;
   std::swap(data_, other.data_);
+  other.sz = other.ln = 0;
   return *this;
 }
 
@@ -0,0 +1,352 @@
+#ifndef SRC_IMPLEMENTATIONS_SIMD_SEARCH_H
+#define SRC_IMPLEMENTATIONS_SIMD_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#include "tree.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define S21_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define S21_SIMD_X86 0
+#endif
+
+namespace s21 {
+// Search kernels for short sorted runs of arithmetic keys. Within a sorted
+// run the position of the first key not less than a probe is just the
+// number of keys less than it, so instead of a dependent chain of
+// comparisons the kernels compare a whole vector register of keys at once
+// and add up the lane masks. The widest instruction set the processor
+// reports is chosen once at run time: AVX2, else SSE2, which every x86-64
+// has. Other targets and other key types count one key at a time, which
+// compilers vectorize on their own where they can.
+
+// key types with kernels; anything else makes SimdSearchable false
+template <class T>
+struct SimdKey : std::false_type {};
+template <>
+struct SimdKey<int> : std::true_type {};
+template <>
+struct SimdKey<uint32_t> : std::true_type {};
+template <>
+struct SimdKey<uint64_t> : std::true_type {};
+template <>
+struct SimdKey<float> : std::true_type {};
+template <>
+struct SimdKey<double> : std::true_type {};
+
+// the kernels apply to containers whose values are the keys themselves,
+// ordered by std::less and looked up by a key of the same type
+template <class Key, class Value, class KeyOfValue, class Compare, class K>
+constexpr bool SimdSearchable() {
+  return SimdKey<Key>::value && std::is_same<Key, Value>::value &&
+         std::is_same<KeyOfValue, KeyIdentity<Key>>::value &&
+         std::is_same<Compare, std::less<Key>>::value &&
+         std::is_same<K, Key>::value;
+}
+
+namespace simd {
+template <class T>
+size_t ScalarCountLess(const T* keys, size_t count, T key) {
+  size_t result{0};
+  for (size_t i = 0; i < count; ++i) result += keys[i] < key;
+  return result;
+}
+
+template <class T>
+size_t ScalarCountGreater(const T* keys, size_t count, T key) {
+  size_t result{0};
+  for (size_t i = 0; i < count; ++i) result += key < keys[i];
+  return result;
+}
+
+#if S21_SIMD_X86
+inline bool CpuHasAvx2() {
+  static const bool has_avx2{__builtin_cpu_supports("avx2") != 0};
+  return has_avx2;
+}
+
+// one specialization per key type: how to load and compare a register of
+// keys with SSE2 and with AVX2. Unsigned keys have their sign bit flipped
+// so that the signed comparisons order them; SSE2 has no 64-bit integer
+// comparison, so uint64_t keys fall back to counting without AVX2.
+template <class T>
+struct Kernels;
+
+template <>
+struct Kernels<int> {
+  static constexpr size_t kSse2Lanes{4};
+  static constexpr size_t kAvx2Lanes{8};
+
+  static size_t LessSse2(const int* keys, int key) {
+    __m128i values{_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys))};
+    __m128i less{_mm_cmplt_epi32(values, _mm_set1_epi32(key))};
+    return __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(less)));
+  }
+
+  static size_t GreaterSse2(const int* keys, int key) {
+    __m128i values{_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys))};
+    __m128i greater{_mm_cmpgt_epi32(values, _mm_set1_epi32(key))};
+    return __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(greater)));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t LessAvx2(const int* keys, int key) {
+    __m256i values{
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys))};
+    __m256i less{_mm256_cmpgt_epi32(_mm256_set1_epi32(key), values)};
+    return __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t GreaterAvx2(const int* keys, int key) {
+    __m256i values{
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys))};
+    __m256i greater{_mm256_cmpgt_epi32(values, _mm256_set1_epi32(key))};
+    return __builtin_popcount(
+        _mm256_movemask_ps(_mm256_castsi256_ps(greater)));
+  }
+};
+
+template <>
+struct Kernels<uint32_t> {
+  static constexpr size_t kSse2Lanes{4};
+  static constexpr size_t kAvx2Lanes{8};
+
+  static int Flip(uint32_t key) { return static_cast<int>(key ^ 0x80000000U); }
+
+  static __m128i LoadSse2(const uint32_t* keys) {
+    return _mm_xor_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)),
+        _mm_set1_epi32(static_cast<int>(0x80000000U)));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static __m256i LoadAvx2(const uint32_t* keys) {
+    return _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys)),
+        _mm256_set1_epi32(static_cast<int>(0x80000000U)));
+  }
+
+  static size_t LessSse2(const uint32_t* keys, uint32_t key) {
+    __m128i less{_mm_cmplt_epi32(LoadSse2(keys), _mm_set1_epi32(Flip(key)))};
+    return __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(less)));
+  }
+
+  static size_t GreaterSse2(const uint32_t* keys, uint32_t key) {
+    __m128i greater{
+        _mm_cmpgt_epi32(LoadSse2(keys), _mm_set1_epi32(Flip(key)))};
+    return __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(greater)));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t LessAvx2(const uint32_t* keys, uint32_t key) {
+    __m256i less{
+        _mm256_cmpgt_epi32(_mm256_set1_epi32(Flip(key)), LoadAvx2(keys))};
+    return __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t GreaterAvx2(const uint32_t* keys, uint32_t key) {
+    __m256i greater{
+        _mm256_cmpgt_epi32(LoadAvx2(keys), _mm256_set1_epi32(Flip(key)))};
+    return __builtin_popcount(
+        _mm256_movemask_ps(_mm256_castsi256_ps(greater)));
+  }
+};
+
+template <>
+struct Kernels<uint64_t> {
+  static constexpr size_t kSse2Lanes{0};
+  static constexpr size_t kAvx2Lanes{4};
+
+  static long long Flip(uint64_t key) {
+    return static_cast<long long>(key ^ 0x8000000000000000ULL);
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static __m256i LoadAvx2(const uint64_t* keys) {
+    return _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys)),
+        _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL)));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t LessAvx2(const uint64_t* keys, uint64_t key) {
+    __m256i less{
+        _mm256_cmpgt_epi64(_mm256_set1_epi64x(Flip(key)), LoadAvx2(keys))};
+    return __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(less)));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t GreaterAvx2(const uint64_t* keys, uint64_t key) {
+    __m256i greater{
+        _mm256_cmpgt_epi64(LoadAvx2(keys), _mm256_set1_epi64x(Flip(key)))};
+    return __builtin_popcount(
+        _mm256_movemask_pd(_mm256_castsi256_pd(greater)));
+  }
+};
+
+template <>
+struct Kernels<float> {
+  static constexpr size_t kSse2Lanes{4};
+  static constexpr size_t kAvx2Lanes{8};
+
+  static size_t LessSse2(const float* keys, float key) {
+    __m128 less{_mm_cmplt_ps(_mm_loadu_ps(keys), _mm_set1_ps(key))};
+    return __builtin_popcount(_mm_movemask_ps(less));
+  }
+
+  static size_t GreaterSse2(const float* keys, float key) {
+    __m128 greater{_mm_cmpgt_ps(_mm_loadu_ps(keys), _mm_set1_ps(key))};
+    return __builtin_popcount(_mm_movemask_ps(greater));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t LessAvx2(const float* keys, float key) {
+    __m256 less{
+        _mm256_cmp_ps(_mm256_loadu_ps(keys), _mm256_set1_ps(key), _CMP_LT_OQ)};
+    return __builtin_popcount(_mm256_movemask_ps(less));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t GreaterAvx2(const float* keys, float key) {
+    __m256 greater{
+        _mm256_cmp_ps(_mm256_loadu_ps(keys), _mm256_set1_ps(key), _CMP_GT_OQ)};
+    return __builtin_popcount(_mm256_movemask_ps(greater));
+  }
+};
+
+template <>
+struct Kernels<double> {
+  static constexpr size_t kSse2Lanes{2};
+  static constexpr size_t kAvx2Lanes{4};
+
+  static size_t LessSse2(const double* keys, double key) {
+    __m128d less{_mm_cmplt_pd(_mm_loadu_pd(keys), _mm_set1_pd(key))};
+    return __builtin_popcount(_mm_movemask_pd(less));
+  }
+
+  static size_t GreaterSse2(const double* keys, double key) {
+    __m128d greater{_mm_cmpgt_pd(_mm_loadu_pd(keys), _mm_set1_pd(key))};
+    return __builtin_popcount(_mm_movemask_pd(greater));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t LessAvx2(const double* keys, double key) {
+    __m256d less{
+        _mm256_cmp_pd(_mm256_loadu_pd(keys), _mm256_set1_pd(key), _CMP_LT_OQ)};
+    return __builtin_popcount(_mm256_movemask_pd(less));
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static size_t GreaterAvx2(const double* keys, double key) {
+    __m256d greater{
+        _mm256_cmp_pd(_mm256_loadu_pd(keys), _mm256_set1_pd(key), _CMP_GT_OQ)};
+    return __builtin_popcount(_mm256_movemask_pd(greater));
+  }
+};
+
+// whole registers through the kernels, the tail one key at a time. The
+// loops carry the target of their kernels, so the kernels inline into them.
+template <class T, bool Greater>
+__attribute__((target("avx2,popcnt")))
+size_t CountAvx2(const T* keys, size_t count, T key) {
+  constexpr size_t lanes{Kernels<T>::kAvx2Lanes};
+  size_t result{0};
+  size_t index{0};
+  for (; index + lanes <= count; index += lanes) {
+    if constexpr (Greater) {
+      result += Kernels<T>::GreaterAvx2(keys + index, key);
+    } else {
+      result += Kernels<T>::LessAvx2(keys + index, key);
+    }
+  }
+  if constexpr (Greater) {
+    return result + ScalarCountGreater(keys + index, count - index, key);
+  } else {
+    return result + ScalarCountLess(keys + index, count - index, key);
+  }
+}
+
+template <class T, bool Greater>
+size_t CountSse2(const T* keys, size_t count, T key) {
+  constexpr size_t lanes{Kernels<T>::kSse2Lanes};
+  size_t result{0};
+  size_t index{0};
+  for (; index + lanes <= count; index += lanes) {
+    if constexpr (Greater) {
+      result += Kernels<T>::GreaterSse2(keys + index, key);
+    } else {
+      result += Kernels<T>::LessSse2(keys + index, key);
+    }
+  }
+  if constexpr (Greater) {
+    return result + ScalarCountGreater(keys + index, count - index, key);
+  } else {
+    return result + ScalarCountLess(keys + index, count - index, key);
+  }
+}
+#endif  // S21_SIMD_X86
+
+// the number of keys less than key
+template <class T>
+size_t CountLess(const T* keys, size_t count, T key) {
+#if S21_SIMD_X86
+  if (CpuHasAvx2()) return CountAvx2<T, false>(keys, count, key);
+  if constexpr (Kernels<T>::kSse2Lanes != 0)
+    return CountSse2<T, false>(keys, count, key);
+#endif
+  return ScalarCountLess(keys, count, key);
+}
+
+// the number of keys greater than key
+template <class T>
+size_t CountGreater(const T* keys, size_t count, T key) {
+#if S21_SIMD_X86
+  if (CpuHasAvx2()) return CountAvx2<T, true>(keys, count, key);
+  if constexpr (Kernels<T>::kSse2Lanes != 0)
+    return CountSse2<T, true>(keys, count, key);
+#endif
+  return ScalarCountGreater(keys, count, key);
+}
+}  // namespace simd
+
+// longer runs are first halved by a branch-free binary search down to one
+// AVX2 register of keys, which the kernels then count. Counting longer runs
+// measured slower: halving costs one comparison per level, counting a
+// register per 32 bytes.
+template <class T>
+constexpr size_t kSimdRun{32 / sizeof(T)};
+
+// the first position in a sorted run whose key is not less than key
+template <class T>
+size_t SimdLowerIndex(const T* keys, size_t count, T key) {
+  size_t base{0};
+  while (count > kSimdRun<T>) {
+    size_t half{count / 2};
+    base += keys[base + half - 1] < key ? half : 0;
+    count -= half;
+  }
+  return base + simd::CountLess(keys + base, count, key);
+}
+
+// the first position in a sorted run whose key is greater than key
+template <class T>
+size_t SimdUpperIndex(const T* keys, size_t count, T key) {
+  size_t base{0};
+  while (count > kSimdRun<T>) {
+    size_t half{count / 2};
+    base += key < keys[base + half - 1] ? 0 : half;
+    count -= half;
+  }
+  return base + count - simd::CountGreater(keys + base, count, key);
+}
+
+}  // namespace s21
+
+#endif  // SRC_IMPLEMENTATIONS_SIMD_SEARCH_H
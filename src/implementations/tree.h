@@ -1,61 +1,141 @@
 #ifndef SRC_IMPLEMENTATIONS_TREE_H
 #define SRC_IMPLEMENTATIONS_TREE_H
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
 #include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "node_pool.h"
+#include "parallel.h"
 
 namespace s21 {
-template <class Key = int>
+// extracts the ordering key of a stored value: the value itself for sets,
+// the first member of the pair for maps
+template <class Key>
+struct KeyIdentity {
+  const Key& operator()(const Key& value) const { return value; }
+};
+
+template <class Pair>
+struct KeySelectFirst {
+  const typename Pair::first_type& operator()(const Pair& value) const {
+    return value.first;
+  }
+};
+
+// Compare orders keys like std::less and is called once per level; a
+// comparator that declares is_transparent also enables lookup by any type it
+// can compare with the key. A ranked tree keeps subtree sizes in its nodes
+// for the order statistics nth, rank and count_range.
+template <class Key = int, class Value = Key,
+          class KeyOfValue = KeyIdentity<Key>,
+          class Compare = std::less<Key>, bool Ranked = false>
 class RBtree {
-  struct tree_node {
-    explicit tree_node(Key data = Key(), tree_node* parent = nullptr,
-                       tree_node* left = nullptr, tree_node* right = nullptr)
-        : data(data), parent(parent), left(left), right(right){};
-    Key data;
-    tree_node* parent;
-    tree_node* left;
-    tree_node* right;
+  enum Color : bool { kRed, kBlack };
+
+  // links only, so that the header needs no value
+  struct node_base {
+    node_base* parent;
+    node_base* left;
+    node_base* right;
+    Color color;
+  };
+
+  // unranked trees get the empty base and pay nothing for the size
+  struct no_size {};
+  struct subtree_size {
+    size_t size;
+  };
+  using size_field =
+      typename std::conditional<Ranked, subtree_size, no_size>::type;
+
+  struct tree_node : node_base, size_field {
+    template <class... Args>
+    explicit tree_node(Args&&... args)
+        : node_base{nullptr, nullptr, nullptr, kRed},
+          size_field{},
+          data(std::forward<Args>(args)...){};
+    Value data;
+  };
+
+  // where a new key goes: under "parent" on the given side, or nowhere
+  // because "existing" already holds the key in a tree without duplicates
+  struct insert_pos {
+    node_base* parent;
+    bool left;
+    node_base* existing;
   };
 
  public:
   using key_type = Key;
+  using value_type = Value;
   using size_type = size_t;
-  using const_reference = const key_type&;
+  using const_reference = const value_type&;
+  using key_compare = Compare;
+
+  RBtree() : RBtree(Compare()) {}
 
-  RBtree() : tree_root_{nullptr}, nodes_count_{0} {}
-  ~RBtree() { clear(tree_root_); }
-  void clear() { clear(tree_root_); }
+  explicit RBtree(const Compare& compare)
+      : header_{}, nodes_count_{0}, compare_{compare} {
+    ResetHeader();
+  }
 
-  void clear(tree_node* root) {
-    if (!root) return;
+  // trivially destructible values need no walk: the pool frees the slabs
+  // nodes spliced in from other trees are given back even when the values
+  // need no destruction
+  ~RBtree() {
+    if (!std::is_trivially_destructible<value_type>::value ||
+        pool_.borrowed())
+      clear();
+  }
 
-    clear(root->left);
-    clear(root->right);
-    RemoveNode(root->data);
+  void clear() {
+    DestroySubtree(header_.parent);
+    ResetHeader();
+    nodes_count_ = 0;
   }
 
   // constructor initializer_list
-  RBtree(std::initializer_list<key_type> const& init, bool duplicate)
-      : tree_root_{nullptr}, nodes_count_{0} {
-    for (auto& it : init) InsertNode(it, duplicate);
+  RBtree(std::initializer_list<value_type> const& init, bool duplicate)
+      : RBtree(init.begin(), init.end(), duplicate) {}
+
+  // constructor range: sorted input is built in linear time, anything else
+  // is inserted at the back with a hint. Only a forward range is checked
+  // for order, a single pass one goes straight to the inserts.
+  template <class Iterator>
+  RBtree(Iterator first, Iterator last, bool duplicate) : RBtree() {
+    InsertRange(
+        first, last, duplicate,
+        typename std::iterator_traits<Iterator>::iterator_category());
   }
 
   // constructor copy
-  RBtree(const RBtree& other) : tree_root_{nullptr}, nodes_count_{0} {
-    *this = other;
-  }
+  RBtree(const RBtree& other) : RBtree(other.compare_) { *this = other; }
 
   // constructor move
-  RBtree(RBtree&& other) noexcept : tree_root_{nullptr}, nodes_count_{0} {
-    swap(other);
-  }
+  RBtree(RBtree&& other) noexcept : RBtree() { swap(other); }
 
-  // operator assignment copy
+  // operator assignment copy: clones the shape and colors of other node by
+  // node in O(n), without comparing keys, into one reserved block
   RBtree& operator=(const RBtree& other) {
-    if (this == &other || other.empty()) return *this;
+    if (this == &other) return *this;
 
     clear();
-    for (auto it = other.begin(); it != other.end(); ++it) InsertNode(*it, 1);
+    compare_ = other.compare_;
+    if (other.empty()) return *this;
 
+    pool_.reserve(other.nodes_count_);
+    node_base* root{CloneSubtree(other.header_.parent, &header_)};
+    header_.parent = root;
+    header_.left = FindMin(root);
+    header_.right = FindMax(root);
+    nodes_count_ = other.nodes_count_;
     return *this;
   }
 
@@ -68,21 +148,21 @@ class RBtree {
     return *this;
   }
 
-  RBtree::tree_node* GetRoot() { return tree_root_; }
+  RBtree::tree_node* GetRoot() { return AsNode(header_.parent); }
 
   template <class key_type>
   class TreeIterator {
    public:
-    using value_type = Key;
+    using value_type = Value;
     using reference = value_type&;
     using pointer = value_type*;
     using iterator = TreeIterator;
 
-    explicit TreeIterator(tree_node* node) : current(node) {}
+    explicit TreeIterator(node_base* node) : current(node) {}
 
-    reference operator*() const { return current->data; }
+    reference operator*() const { return AsNode(current)->data; }
 
-    pointer operator->() const { return &(current->data); }
+    pointer operator->() const { return &(AsNode(current)->data); }
 
     iterator& operator++() {
       if (current->right) {
@@ -90,12 +170,14 @@ class RBtree {
         while (current->left) current = current->left;
 
       } else {
-        tree_node* parent{current->parent};
-        while (parent && current == parent->right) {
+        node_base* parent{current->parent};
+        while (current == parent->right) {
           current = parent;
           parent = parent->parent;
         }
-        current = parent;
+        // stepping off the rightmost node of a root without a right child
+        // already stops at the header
+        if (current->right != parent) current = parent;
       }
       return *this;
     }
@@ -107,13 +189,15 @@ class RBtree {
     }
 
     iterator& operator--() {
-      if (current->left) {
+      if (IsHeader(current)) {
+        current = current->right;
+      } else if (current->left) {
         current = current->left;
         while (current->right) current = current->right;
 
       } else {
-        tree_node* parent = current->parent;
-        while (parent && current == parent->left) {
+        node_base* parent = current->parent;
+        while (current == parent->left) {
           current = parent;
           parent = parent->parent;
         }
@@ -135,8 +219,8 @@ class RBtree {
     bool operator!=(const iterator& other) const { return !(*this == other); }
 
    private:
-    tree_node* current;
-    friend class RBtree<value_type>;
+    node_base* current;
+    friend class RBtree;
   };  // class TreeIterator
 
   template <class key_type>
@@ -150,146 +234,1658 @@ class RBtree {
   using iterator = TreeIterator<key_type>;
   using const_iterator = ConstTreeIterator<key_type>;
 
-  RBtree<key_type>::iterator begin() const {
-    tree_node* current{tree_root_};
+  iterator begin() const { return iterator(header_.left); }
 
-    while (current && current->left) current = current->left;
+  iterator end() const { return iterator(const_cast<node_base*>(&header_)); }
 
-    return iterator(current);
+  iterator find(const key_type& key) const {
+    node_base* current{FindNodeByKey(key)};
+    return current ? iterator(current) : end();
   }
 
-  RBtree<key_type>::iterator end() const {
-    tree_node* current{tree_root_};
-    while (current->right) current = current->right;
+  // the first element not less than key
+  iterator lower_bound(const key_type& key) const {
+    return iterator(LowerBound(key));
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator lower_bound(const K& key) const {
+    return iterator(LowerBound(key));
+  }
 
-    return ++iterator(current);
+  // the first element greater than key
+  iterator upper_bound(const key_type& key) const {
+    return iterator(UpperBound(key));
   }
 
-  RBtree<key_type>::iterator find(const key_type& key) {
-    tree_node* current{FindNodeByKey(tree_root_, key)};
-    return iterator(current);
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator upper_bound(const K& key) const {
+    return iterator(UpperBound(key));
   }
 
-  bool contains(const key_type& key) {
-    return FindNodeByKey(tree_root_, key) != nullptr;
+  std::pair<iterator, iterator> equal_range(const key_type& key) const {
+    return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  // walks the equal keys only: O(log n + count)
+  size_type count(const key_type& key) const { return CountKey(key); }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return CountKey(key);
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator find(const K& key) const {
+    node_base* current{FindNodeByKey(key)};
+    return current ? iterator(current) : end();
+  }
+
+  bool contains(const key_type& key) const {
+    return FindNodeByKey(key) != nullptr;
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return FindNodeByKey(key) != nullptr;
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+  // the element at position k in order, or end() if there is none
+  iterator nth(size_type k) {
+    static_assert(Ranked, "s21::RBtree: nth needs a ranked tree");
+    node_base* current{header_.parent};
+    while (current) {
+      size_type left{SizeOf(current->left)};
+      if (k < left) {
+        current = current->left;
+      } else if (k == left) {
+        return iterator(current);
+      } else {
+        k -= left + 1;
+        current = current->right;
+      }
+    }
+    return end();
+  }
+
+  // the number of elements with keys less than key
+  size_type rank(const key_type& key) const { return Rank(key); }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type rank(const K& key) const {
+    return Rank(key);
+  }
+
+  // the number of elements with keys in [low, high)
+  size_type count_range(const key_type& low, const key_type& high) const {
+    return CountRange(low, high);
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count_range(const K& low, const K& high) const {
+    return CountRange(low, high);
   }
 
   bool empty() const { return nodes_count_ == 0; }
 
-  void erase(iterator pos) { RemoveNode(*pos); }
+  void erase(iterator pos) { RemoveNode(AsNode(pos.current)); }
+
+  // returns the inserted node, or the node holding the key when duplicates
+  // are not allowed and the key is already there
+  std::pair<iterator, bool> insert(const value_type& value, bool duplicate) {
+    std::pair<node_base*, bool> result{InsertNode(value, duplicate)};
+    return std::pair<iterator, bool>(iterator(result.first), result.second);
+  }
 
-  std::pair<iterator, bool> insert(const key_type& value, bool duplicate) {
-    bool result{InsertNode(value, duplicate)};
-    iterator it = end();
-    if (result) it = find(value);
+  // builds the value in place first, since its key is only known then
+  template <class... Args>
+  std::pair<iterator, bool> emplace(bool duplicate, Args&&... args) {
+    tree_node* node{CreateNode(std::forward<Args>(args)...)};
+    insert_pos pos;
+    try {
+      pos = FindInsertPos(KeyOf(node), duplicate);
+    } catch (...) {
+      DestroyNode(node);
+      throw;
+    }
+    if (pos.existing) {
+      DestroyNode(node);
+      return std::pair<iterator, bool>(iterator(pos.existing), false);
+    }
+
+    LinkNode(node, pos);
+    return std::pair<iterator, bool>(iterator(node), true);
+  }
+
+  // inserts next to the hint in amortized O(1) when the value belongs there
+  std::pair<iterator, bool> insert(iterator hint, const value_type& value,
+                                   bool duplicate) {
+    insert_pos pos{FindInsertHintPos(hint, KeyOf(value), duplicate)};
+    if (pos.existing)
+      return std::pair<iterator, bool>(iterator(pos.existing), false);
+
+    tree_node* node{CreateNode(value)};
+    LinkNode(node, pos);
+    return std::pair<iterator, bool>(iterator(node), true);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace_hint(iterator hint, bool duplicate,
+                                         Args&&... args) {
+    tree_node* node{CreateNode(std::forward<Args>(args)...)};
+    insert_pos pos;
+    try {
+      pos = FindInsertHintPos(hint, KeyOf(node), duplicate);
+    } catch (...) {
+      DestroyNode(node);
+      throw;
+    }
+    if (pos.existing) {
+      DestroyNode(node);
+      return std::pair<iterator, bool>(iterator(pos.existing), false);
+    }
 
-    return std::pair<iterator, bool>(it, result);
+    LinkNode(node, pos);
+    return std::pair<iterator, bool>(iterator(node), true);
+  }
+
+  // builds the value from args only if the key is not in the tree yet
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    insert_pos pos{FindInsertPos(key, false)};
+    if (pos.existing)
+      return std::pair<iterator, bool>(iterator(pos.existing), false);
+
+    tree_node* node{CreateNode(std::forward<Args>(args)...)};
+    LinkNode(node, pos);
+    return std::pair<iterator, bool>(iterator(node), true);
   }
 
   void swap(RBtree& other) {
-    std::swap(tree_root_, other.tree_root_);
+    std::swap(header_, other.header_);
     std::swap(nodes_count_, other.nodes_count_);
+    pool_.swap(other.pool_);
+    std::swap(compare_, other.compare_);
+    RelinkHeader();
+    other.RelinkHeader();
   }
 
   size_type size() const { return nodes_count_; }
 
+  // preallocates nodes so that the tree can hold count elements without
+  // going back to the heap
+  void reserve(size_type count) {
+    if (count > nodes_count_) pool_.reserve(count - nodes_count_);
+  }
+
+  // the elements plus the spare nodes of the pool
+  size_type capacity() const { return nodes_count_ + pool_.available(); }
+
   size_type max_size() const {
-    size_type size =
-        std::numeric_limits<size_type>::max() / sizeof(tree_node) / 2.5;
-    size -= 13;
-    return size;
+    return std::numeric_limits<std::ptrdiff_t>::max() / sizeof(tree_node);
   }
 
+  // moves the nodes of other whose keys fit into this tree by relinking
+  // them: nothing is allocated or copied and iterators to the moved
+  // elements stay valid. The nodes are handed over to this tree's pool, see
+  // node_pool.h, so both trees may still be used from different threads
+  // afterwards. Into an empty tree the whole of other is taken over as it
+  // is. A few nodes are spliced one by one in O(m log(n + m)); when other
+  // is large both trees are flattened, merged in one pass and rebuilt in
+  // O(n + m).
   void merge(RBtree& other, bool duplicate) {
-    RBtree<key_type> temp(other);
-    for (auto it = temp.begin(); it != temp.end(); ++it) {
-      if (!find(*it).current || duplicate) {
-        insert(*it, duplicate);
-        other.erase(it);
+    if (this == &other || other.empty()) return;
+    if (empty()) {
+      Exchange(other);
+      return;
+    }
+
+    size_type total{nodes_count_ + other.nodes_count_};
+    size_type depth{0};
+    while ((size_type{1} << depth) < total) depth++;
+    if (other.nodes_count_ * depth > total) {
+      MergeFlat(other, duplicate);
+      return;
+    }
+
+    pool_.prepare(other.pool_);
+    node_base* current{other.header_.left};
+    while (current != &other.header_) {
+      node_base* node{current};
+      current = (++iterator(current)).current;
+      insert_pos pos{FindInsertPos(KeyOf(node), duplicate)};
+      if (pos.existing) continue;
+      other.pool_.transfer(AsNode(node), pool_);
+      other.UnlinkNode(node);
+      LinkNode(node, pos);
+    }
+  }
+
+  // Set algebra by split and join: the tree driving the recursion is cut
+  // at the other one's root key, both sides are combined recursively (on
+  // two threads while threads allow it) and joined back at that key. For
+  // sizes m <= n that costs O(m log(n/m + 1)) comparisons, plus the
+  // destruction of the nodes dropped. Of equal keys the values of this
+  // tree are kept; with duplicates the multiplicities follow the std
+  // algorithms: the larger count for a union, the smaller one for an
+  // intersection, and what is left of this tree's count for a difference.
+
+  // takes over the nodes of other, which is left empty. The nodes of the
+  // smaller tree are handed over to the pool of the larger one, so the
+  // hand-over stays within the bound.
+  void unite(RBtree&& other, bool duplicate, size_type threads) {
+    if (this == &other || other.empty()) return;
+
+    bool swapped{other.nodes_count_ > nodes_count_};
+    if (swapped) Exchange(other);
+    size_type total{nodes_count_ + other.nodes_count_};
+    threads = AlgebraThreads(total, threads);
+    try {
+      pool_.prepare(other.pool_);
+    } catch (...) {
+      if (swapped) Exchange(other);
+      throw;
+    }
+    for (node_base* node = other.header_.left; node != &other.header_;
+         node = (++iterator(node)).current)
+      other.pool_.transfer(AsNode(node), pool_);
+    subtree theirs{other.Detach()};
+    subtree mine{Detach()};
+    ledger dropped{};
+    subtree result{swapped ? Unite(theirs, mine, duplicate, threads, dropped)
+                           : Unite(mine, theirs, duplicate, threads, dropped)};
+    Hang(result.root, total - DestroyDropped(dropped));
+  }
+
+  // copies the values of other into this tree's pool first
+  void unite(const RBtree& other, bool duplicate, size_type threads) {
+    if (this == &other || other.empty()) return;
+
+    size_type total{nodes_count_ + other.nodes_count_};
+    threads = AlgebraThreads(total, threads);
+    subtree theirs{Import(other)};
+    subtree mine{Detach()};
+    ledger dropped{};
+    subtree result{Unite(mine, theirs, duplicate, threads, dropped)};
+    Hang(result.root, total - DestroyDropped(dropped));
+  }
+
+  // keeps the values whose keys other has as well, other is only read
+  void intersect(const RBtree& other, bool duplicate, size_type threads) {
+    if (this == &other) return;
+
+    size_type count{nodes_count_};
+    threads = AlgebraThreads(count + other.nodes_count_, threads);
+    ledger dropped{};
+    subtree result{
+        Intersect(Detach(), other.header_.parent, duplicate, threads, dropped)};
+    Hang(result.root, count - DestroyDropped(dropped));
+  }
+
+  // removes the values whose keys other has, other is only read
+  void subtract(const RBtree& other, bool duplicate, size_type threads) {
+    if (this == &other) {
+      clear();
+      return;
+    }
+
+    size_type count{nodes_count_};
+    threads = AlgebraThreads(count + other.nodes_count_, threads);
+    ledger dropped{};
+    subtree result{
+        Subtract(Detach(), other.header_.parent, duplicate, threads, dropped)};
+    Hang(result.root, count - DestroyDropped(dropped));
+  }
+
+  // replaces the contents with a sorted range in O(n): the nodes come from
+  // one reservation and are chained through their right links in order,
+  // then linked into a perfectly balanced tree. Equal keys are dropped
+  // unless duplicates are allowed, unsorted input throws.
+  template <class Iterator>
+  void build_from_sorted(Iterator first, Iterator last, bool duplicate) {
+    clear();
+    if constexpr (std::is_base_of<std::forward_iterator_tag,
+                                  typename std::iterator_traits<
+                                      Iterator>::iterator_category>::value)
+      pool_.reserve(std::distance(first, last));
+
+    node_base* head{nullptr};
+    node_base* tail{nullptr};
+    size_type count{0};
+    try {
+      for (; first != last; ++first) {
+        const value_type& value = *first;
+        if (tail && Less(KeyOf(value), KeyOf(tail)))
+          throw std::invalid_argument("s21::RBtree: range is not sorted");
+        if (tail && !duplicate && !Less(KeyOf(tail), KeyOf(value))) continue;
+
+        node_base* node{CreateNode(value)};
+        (tail ? tail->right : head) = node;
+        tail = node;
+        count++;
+      }
+    } catch (...) {
+      while (head) {
+        node_base* next{head->right};
+        DestroyNode(AsNode(head));
+        head = next;
+      }
+      throw;
+    }
+    LinkChain(head, count);
+  }
+
+  // replaces the contents with an unsorted range using up to threads
+  // threads, 0 meaning one per hardware thread. The values are copied once
+  // and merge sorted in parallel (stably, so of equal keys the first one
+  // is kept unless duplicates are allowed); then the nodes are taken from
+  // one reservation, constructed in parallel slices and linked into the
+  // same balanced shape as build_from_sorted, the subtrees on different
+  // threads. Values must be default constructible for the sort buffer.
+  template <class Iterator>
+  void build_from_unsorted(Iterator first, Iterator last, bool duplicate,
+                           size_type threads) {
+    std::vector<value_type> items(first, last);
+    threads = parallel::Threads(threads);
+    auto key_less = [this](const value_type& a, const value_type& b) {
+      return Less(KeyOf(a), KeyOf(b));
+    };
+    if (threads > 1 && items.size() >= 2 * parallel::kGrain) {
+      std::vector<value_type> buffer(items.size());
+      parallel::Sort(items.data(), items.data() + items.size(),
+                     buffer.data(), key_less, threads);
+    } else {
+      std::stable_sort(items.begin(), items.end(), key_less);
+    }
+    size_type count{items.size()};
+    if (!duplicate) {
+      count = std::unique(items.begin(), items.end(),
+                          [this](const value_type& a, const value_type& b) {
+                            return !Less(KeyOf(a), KeyOf(b));
+                          }) -
+              items.begin();
+    }
+
+    clear();
+    pool_.reserve(count);
+    std::vector<tree_node*> nodes(count);
+    for (tree_node*& node : nodes) node = pool_.allocate();
+
+    // a byte per node rather than std::vector<bool>, so that the slices
+    // never write to the same memory location
+    std::vector<unsigned char> built(count);
+    auto construct = [&nodes, &items, &built](size_type begin, size_type end) {
+      for (size_type i = begin; i < end; ++i) {
+        new (nodes[i]) tree_node(std::move(items[i]));
+        built[i] = 1;
+      }
+    };
+    try {
+      parallel::ForRange(0, count, threads, construct);
+    } catch (...) {
+      for (size_type i = 0; i < count; ++i) {
+        if (built[i]) nodes[i]->~tree_node();
+        pool_.deallocate(nodes[i]);
       }
+      throw;
     }
+    Hang(LinkNodes(nodes.data(), count, 0, RedDepth(count), threads), count);
+  }
+
+  // calls f(value) for every value on up to threads threads, 0 meaning one
+  // per hardware thread. The tree is cut at the top into a few times more
+  // pieces than threads (whole subtrees and the single nodes between
+  // them, by subtree size in a ranked tree and by depth otherwise) and the
+  // threads share the pieces out by work stealing. Each piece is walked in
+  // order with a stack instead of climbing parent links; f must be safe to
+  // call from several threads at once.
+  template <class Function>
+  void parallel_for_each(Function f, size_type threads) const {
+    std::vector<piece> pieces{Cut(threads)};
+    auto run = [&pieces, &f](size_t i) { Walk(pieces[i], f); };
+    parallel::RunTasks(pieces.size(), threads, run);
+  }
+
+  // folds the values in key order: every piece starts from identity and
+  // is folded with accumulate(result, value), then the results of the
+  // pieces are folded in order with combine(left, right). combine must be
+  // associative with identity as its neutral value; it need not commute.
+  template <class Result, class Accumulate, class Combine>
+  Result parallel_reduce(Result identity, Accumulate accumulate,
+                         Combine combine, size_type threads) const {
+    std::vector<piece> pieces{Cut(threads)};
+    // a struct rather than Result itself, so that results of bool are not
+    // packed into the bits of one word that several threads write
+    struct result {
+      Result value;
+    };
+    std::vector<result> results(pieces.size(), result{identity});
+    auto run = [&](size_t i) {
+      Result& value{results[i].value};
+      Walk(pieces[i], [&value, &accumulate](const value_type& item) {
+        value = accumulate(std::move(value), item);
+      });
+    };
+    parallel::RunTasks(pieces.size(), threads, run);
+
+    for (result& part : results)
+      identity = combine(std::move(identity), std::move(part.value));
+    return identity;
+  }
+
+  // checks the red-black invariants: black root, no red node with a red
+  // child, the same number of black nodes on every path, ordered keys and
+  // consistent parent links; together they bound the height by 2*log2(n+1)
+  bool CheckBalance() const {
+    const node_base* root{header_.parent};
+    if (!root) return header_.left == &header_ && header_.right == &header_;
+    if (root->color == kRed || root->parent != &header_) return false;
+
+    const node_base* leftmost{root};
+    while (leftmost->left) leftmost = leftmost->left;
+    const node_base* rightmost{root};
+    while (rightmost->right) rightmost = rightmost->right;
+    if (header_.left != leftmost || header_.right != rightmost) return false;
+
+    return BlackHeight(root) != -1;
   }
 
  private:
-  tree_node* tree_root_;
+  // header_.parent is the root, header_.left and header_.right cache the
+  // leftmost and rightmost nodes, and the header itself is end()
+  node_base header_;
   size_type nodes_count_;
+  NodePool<tree_node> pool_;
+  Compare compare_;
 
-  bool InsertNode(key_type data, bool duplicate) {
-    if (!tree_root_) {
-      tree_root_ = new tree_node(data);
-      nodes_count_++;
-      return true;
-    }
-    if (duplicate || !find(data).current) {
-      tree_node* current{tree_root_};
-      tree_node* parent{nullptr};
-      while (current) {
-        parent = current;
-        if (data < current->data) {
-          current = current->left;
-        } else {
-          current = current->right;
+  static tree_node* AsNode(node_base* node) {
+    return static_cast<tree_node*>(node);
+  }
+
+  static const tree_node* AsNode(const node_base* node) {
+    return static_cast<const tree_node*>(node);
+  }
+
+  // the header is the only red node whose grandparent is itself; an empty
+  // tree's header has no parent at all
+  static bool IsHeader(const node_base* node) {
+    return node->color == kRed &&
+           (!node->parent || node->parent->parent == node);
+  }
+
+  void ResetHeader() {
+    header_.parent = nullptr;
+    header_.left = header_.right = &header_;
+    header_.color = kRed;
+  }
+
+  // points the root back at this header after the header was copied
+  void RelinkHeader() {
+    if (header_.parent) {
+      header_.parent->parent = &header_;
+    } else {
+      header_.left = header_.right = &header_;
+    }
+  }
+
+  // swaps the elements with other, each tree keeps its comparator
+  void Exchange(RBtree& other) {
+    std::swap(compare_, other.compare_);
+    swap(other);
+    std::swap(compare_, other.compare_);
+  }
+
+  template <class Iterator>
+  void InsertRange(Iterator first, Iterator last, bool duplicate,
+                   std::forward_iterator_tag) {
+    auto key_less = [this](const value_type& a, const value_type& b) {
+      return Less(KeyOf(a), KeyOf(b));
+    };
+    if (std::is_sorted(first, last, key_less)) {
+      build_from_sorted(first, last, duplicate);
+    } else {
+      for (; first != last; ++first) insert(end(), *first, duplicate);
+    }
+  }
+
+  template <class Iterator>
+  void InsertRange(Iterator first, Iterator last, bool duplicate,
+                   std::input_iterator_tag) {
+    for (; first != last; ++first) insert(end(), *first, duplicate);
+  }
+
+  template <class... Args>
+  tree_node* CreateNode(Args&&... args) {
+    tree_node* node{pool_.allocate()};
+    try {
+      new (node) tree_node(std::forward<Args>(args)...);
+    } catch (...) {
+      pool_.deallocate(node);
+      throw;
+    }
+    return node;
+  }
+
+  void DestroyNode(tree_node* node) {
+    node->~tree_node();
+    pool_.deallocate(node);
+  }
+
+  // post-order walk over the parent links: every node is visited a constant
+  // number of times, without key comparisons or recursion; returns how
+  // many nodes were destroyed
+  size_type DestroySubtree(node_base* root) {
+    size_type count{0};
+    node_base* current{root};
+    while (current) {
+      if (current->left) {
+        current = current->left;
+      } else if (current->right) {
+        current = current->right;
+      } else {
+        node_base* parent{current == root ? nullptr : current->parent};
+        if (parent && parent->left == current) {
+          parent->left = nullptr;
+        } else if (parent) {
+          parent->right = nullptr;
         }
+        DestroyNode(AsNode(current));
+        count++;
+        current = parent;
       }
-      if (data < parent->data) {
-        parent->left = new tree_node(data);
-        parent->left->parent = parent;
-        nodes_count_++;
+    }
+    return count;
+  }
+
+  node_base* CloneNode(const node_base* source, node_base* parent) {
+    tree_node* node{CreateNode(AsNode(source)->data)};
+    node->parent = parent;
+    node->color = source->color;
+    if constexpr (Ranked) node->size = AsNode(source)->size;
+    return node;
+  }
+
+  // recurses into right subtrees and loops down the left spine, so the
+  // stack depth is bounded by the height; a throwing copy frees the clone
+  node_base* CloneSubtree(const node_base* source, node_base* parent) {
+    node_base* top{CloneNode(source, parent)};
+    try {
+      if (source->right) top->right = CloneSubtree(source->right, top);
+      node_base* current{top};
+      for (source = source->left; source; source = source->left) {
+        node_base* node{CloneNode(source, current)};
+        current->left = node;
+        if (source->right) node->right = CloneSubtree(source->right, node);
+        current = node;
+      }
+    } catch (...) {
+      DestroySubtree(top);
+      throw;
+    }
+    return top;
+  }
+
+  template <class A, class B>
+  bool Less(const A& a, const B& b) const {
+    return compare_(a, b);
+  }
+
+  static const key_type& KeyOf(const value_type& value) {
+    return KeyOfValue()(value);
+  }
+
+  static const key_type& KeyOf(const node_base* node) {
+    return KeyOf(AsNode(node)->data);
+  }
+
+  std::pair<node_base*, bool> InsertNode(const value_type& data,
+                                         bool duplicate) {
+    insert_pos pos{FindInsertPos(KeyOf(data), duplicate)};
+    if (pos.existing) return std::pair<node_base*, bool>(pos.existing, false);
+
+    tree_node* node{CreateNode(data)};
+    LinkNode(node, pos);
+    return std::pair<node_base*, bool>(node, true);
+  }
+
+  // a single descent; equal keys go right, so duplicates keep their
+  // insertion order. Without duplicates an equal key can only sit in the
+  // in-order predecessor of the insertion point, one step away.
+  insert_pos FindInsertPos(const key_type& key, bool duplicate) {
+    node_base* current{header_.parent};
+    node_base* parent{&header_};
+    bool left{true};
+    while (current) {
+      parent = current;
+      left = Less(key, KeyOf(current));
+      current = left ? current->left : current->right;
+    }
+
+    node_base* previous{parent};
+    if (duplicate || (left && parent == header_.left)) {
+      previous = nullptr;
+    } else if (left) {
+      previous = (--iterator(parent)).current;
+    }
+    if (previous && !Less(KeyOf(previous), key))
+      return insert_pos{parent, left, previous};
+
+    return insert_pos{parent, left, nullptr};
+  }
+
+  // compares the key with the hint and its neighbour only; if the key
+  // belongs between them, one of the two has a free child slot on the side
+  // facing the other. Wrong hints fall back to a descent from the root.
+  insert_pos FindInsertHintPos(iterator hint, const key_type& key,
+                               bool duplicate) {
+    node_base* pos{hint.current};
+    if (pos == &header_) {
+      if (nodes_count_ && (duplicate ? !Less(key, KeyOf(header_.right))
+                                     : Less(KeyOf(header_.right), key)))
+        return insert_pos{header_.right, false, nullptr};
+
+      return FindInsertPos(key, duplicate);
+    }
+
+    if (duplicate ? !Less(KeyOf(pos), key) : Less(key, KeyOf(pos))) {
+      if (pos == header_.left) return insert_pos{pos, true, nullptr};
+
+      node_base* before{(--iterator(pos)).current};
+      if (duplicate ? !Less(key, KeyOf(before)) : Less(KeyOf(before), key)) {
+        if (!before->right) return insert_pos{before, false, nullptr};
+        return insert_pos{pos, true, nullptr};
+      }
+      return FindInsertPos(key, duplicate);
+    }
+
+    if (duplicate || Less(KeyOf(pos), key)) {
+      if (pos == header_.right) return insert_pos{pos, false, nullptr};
+
+      node_base* after{(++iterator(pos)).current};
+      if (duplicate ? !Less(KeyOf(after), key) : Less(key, KeyOf(after))) {
+        if (!pos->right) return insert_pos{pos, false, nullptr};
+        return insert_pos{after, true, nullptr};
+      }
+      return FindInsertPos(key, duplicate);
+    }
+
+    return insert_pos{pos, false, pos};
+  }
+
+  void LinkNode(node_base* node, const insert_pos& pos) {
+    node->left = node->right = nullptr;
+    node->color = kRed;
+    node->parent = pos.parent;
+    if (pos.parent == &header_) {
+      header_.parent = header_.left = header_.right = node;
+    } else if (pos.left) {
+      pos.parent->left = node;
+      if (pos.parent == header_.left) header_.left = node;
+    } else {
+      pos.parent->right = node;
+      if (pos.parent == header_.right) header_.right = node;
+    }
+    nodes_count_++;
+    Resize(node);
+    if constexpr (Ranked) {
+      for (node_base* above{node->parent}; above != &header_;
+           above = above->parent)
+        AsNode(above)->size++;
+    }
+    InsertFixup(node);
+  }
+
+  // replaces the empty tree with count nodes chained through their right
+  // links in order. Levels above the last one are full; if the last one is
+  // not, its nodes are red so that every path has the same number of black
+  // nodes.
+  void LinkChain(node_base* head, size_type count) {
+    Hang(LinkSorted(head, count, 0, RedDepth(count)), count);
+  }
+
+  // the depth of the last level when it is not full, its nodes are red
+  static size_type RedDepth(size_type count) {
+    size_type full_levels{0};
+    while ((size_type{2} << full_levels) - 1 <= count) full_levels++;
+    return (size_type{1} << full_levels) - 1 == count
+               ? std::numeric_limits<size_type>::max()
+               : full_levels;
+  }
+
+  // makes a linked tree of count nodes the contents of the empty tree, its
+  // root turns black
+  void Hang(node_base* root, size_type count) {
+    if (root) {
+      root->color = kBlack;
+      root->parent = &header_;
+      header_.parent = root;
+      header_.left = FindMin(root);
+      header_.right = FindMax(root);
+    }
+    nodes_count_ = count;
+  }
+
+  // straightens the tree into its in-order chain through the right links
+  // with right rotations (Day-Stout-Warren) and leaves the tree empty
+  node_base* Flatten() {
+    node_base vine{};
+    vine.right = header_.parent;
+    node_base* tail{&vine};
+    node_base* rest{vine.right};
+    while (rest) {
+      if (!rest->left) {
+        tail = rest;
+        rest = rest->right;
       } else {
-        parent->right = new tree_node(data);
-        parent->right->parent = parent;
-        nodes_count_++;
+        node_base* left{rest->left};
+        rest->left = left->right;
+        left->right = rest;
+        rest = left;
+        tail->right = left;
       }
-      return true;
     }
-    return false;
+    ResetHeader();
+    nodes_count_ = 0;
+    return vine.right;
   }
 
-  RBtree::tree_node* FindMin(tree_node* current) {
-    if (current) {
-      while (current->left) current = current->left;
+  // merges both in-order chains; equal keys from this tree go first and the
+  // nodes of other that are not taken are rebuilt into other
+  void MergeFlat(RBtree& other, bool duplicate) {
+    pool_.prepare(other.pool_);
+    node_base* mine{Flatten()};
+    node_base* theirs{other.Flatten()};
+    node_base merged{};
+    node_base kept{};
+    node_base* merged_tail{&merged};
+    node_base* kept_tail{&kept};
+    size_type merged_count{0};
+    size_type kept_count{0};
+
+    while (mine || theirs) {
+      if (!theirs || (mine && !Less(KeyOf(theirs), KeyOf(mine)))) {
+        merged_tail = merged_tail->right = mine;
+        mine = mine->right;
+        merged_count++;
+      } else if (!duplicate && merged_count &&
+                 !Less(KeyOf(merged_tail), KeyOf(theirs))) {
+        kept_tail = kept_tail->right = theirs;
+        theirs = theirs->right;
+        kept_count++;
+      } else {
+        other.pool_.transfer(AsNode(theirs), pool_);
+        merged_tail = merged_tail->right = theirs;
+        theirs = theirs->right;
+        merged_count++;
+      }
     }
 
-    return current;
+    LinkChain(merged.right, merged_count);
+    other.LinkChain(kept.right, kept_count);
   }
 
-  void RemoveNode(key_type data) { tree_root_ = RemoveNode(tree_root_, data); }
-
-  RBtree::tree_node* RemoveNode(tree_node* current, key_type data) {
-    if (!current) return nullptr;
-
-    if (data < current->data) {
-      current->left = RemoveNode(current->left, data);
-    } else if (data > current->data) {
-      current->right = RemoveNode(current->right, data);
-    } else if (data == current->data) {
-      if (!current->left && !current->right) {
-        delete current;
-        current = nullptr;
-      } else if (!current->left || !current->right) {
-        tree_node* temp{current};
-        current->left == nullptr ? current = current->right
-                                 : current = current->left;
-        current->parent = temp->parent;
-        delete temp;
+  // consumes count nodes of the chain in order and returns the root of the
+  // subtree made of them; sides differ in size by at most one
+  static node_base* LinkSorted(node_base*& chain, size_type count,
+                               size_type depth, size_type red_depth) {
+    if (!count) return nullptr;
+
+    size_type left_count{(count - 1) / 2};
+    node_base* left{LinkSorted(chain, left_count, depth + 1, red_depth)};
+    node_base* node{chain};
+    chain = chain->right;
+    node_base* right{
+        LinkSorted(chain, count - 1 - left_count, depth + 1, red_depth)};
+
+    node->left = left;
+    node->right = right;
+    if (left) left->parent = node;
+    if (right) right->parent = node;
+    node->color = depth == red_depth ? kRed : kBlack;
+    Resize(node);
+    return node;
+  }
+
+  // a detached red-black tree: its root may be red and has no parent, the
+  // height counts the black nodes on every path down, the root included
+  struct subtree {
+    node_base* root;
+    size_type height;
+  };
+
+  // the roots of the subtrees set algebra throws away, chained through
+  // their parent links so that dropping needs no memory
+  struct ledger {
+    node_base* head;
+    node_base* tail;
+  };
+
+  // a run of equal keys chained through the right links in order
+  struct run {
+    node_base* head;
+    size_type count;
+  };
+
+  static size_type AlgebraThreads(size_type total, size_type threads) {
+    return total < 2 * parallel::kGrain ? 1 : parallel::Threads(threads);
+  }
+
+  // empties the tree and hands out its nodes
+  subtree Detach() {
+    subtree result{header_.parent, 0};
+    for (const node_base* node = result.root; node; node = node->left)
+      result.height += node->color == kBlack;
+    ResetHeader();
+    nodes_count_ = 0;
+    return result;
+  }
+
+  // copies of the values of other in new nodes of this pool, shaped like
+  // other; the nodes are reserved first
+  subtree Import(const RBtree& other) {
+    pool_.reserve(other.nodes_count_);
+    subtree result{CloneSubtree(other.header_.parent, nullptr), 0};
+    for (const node_base* node = result.root; node; node = node->left)
+      result.height += node->color == kBlack;
+    return result;
+  }
+
+  static subtree LeftOf(const subtree& tree) {
+    return subtree{tree.root->left,
+                   tree.height - (tree.root->color == kBlack)};
+  }
+
+  static subtree RightOf(const subtree& tree) {
+    return subtree{tree.root->right,
+                   tree.height - (tree.root->color == kBlack)};
+  }
+
+  // node over two subtrees of equal height
+  static subtree Make(const subtree& left, node_base* node,
+                      const subtree& right, Color color) {
+    node->left = left.root;
+    node->right = right.root;
+    if (left.root) left.root->parent = node;
+    if (right.root) right.root->parent = node;
+    node->color = color;
+    Resize(node);
+    return subtree{node, left.height + (color == kBlack)};
+  }
+
+  static node_base* RotateUpRight(node_base* node) {
+    node_base* pivot{node->right};
+    node->right = pivot->left;
+    if (pivot->left) pivot->left->parent = node;
+    pivot->left = node;
+    node->parent = pivot;
+    Resize(node);
+    Resize(pivot);
+    return pivot;
+  }
+
+  static node_base* RotateUpLeft(node_base* node) {
+    node_base* pivot{node->left};
+    node->left = pivot->right;
+    if (pivot->right) pivot->right->parent = node;
+    pivot->right = node;
+    node->parent = pivot;
+    Resize(node);
+    Resize(pivot);
+    return pivot;
+  }
+
+  // hangs node and the lower right down the right spine of the higher
+  // left, at the first black node of the same height; a red parent above
+  // it is lifted by a rotation on the way back up. The height of left is
+  // kept, only its root may end up red over a red right child.
+  static subtree JoinRight(const subtree& left, node_base* node,
+                           const subtree& right) {
+    if (IsBlack(left.root) && left.height == right.height)
+      return Make(left, node, right, kRed);
+
+    Color color{left.root->color};
+    subtree lower{JoinRight(RightOf(left), node, right)};
+    subtree result{Make(LeftOf(left), left.root, lower, color)};
+    node_base* top{result.root};
+    if (color == kBlack && IsRed(top->right) && IsRed(top->right->right)) {
+      top->right->right->color = kBlack;
+      result.root = RotateUpRight(top);
+    }
+    return result;
+  }
+
+  static subtree JoinLeft(const subtree& left, node_base* node,
+                          const subtree& right) {
+    if (IsBlack(right.root) && left.height == right.height)
+      return Make(left, node, right, kRed);
+
+    Color color{right.root->color};
+    subtree lower{JoinLeft(left, node, LeftOf(right))};
+    subtree result{Make(lower, right.root, RightOf(right), color)};
+    node_base* top{result.root};
+    if (color == kBlack && IsRed(top->left) && IsRed(top->left->left)) {
+      top->left->left->color = kBlack;
+      result.root = RotateUpLeft(top);
+    }
+    return result;
+  }
+
+  // left, node and right in this order as one tree, in O(difference of
+  // the heights)
+  static subtree Join(subtree left, node_base* node, subtree right) {
+    if (IsRed(left.root)) {
+      left.root->color = kBlack;
+      left.height++;
+    }
+    if (IsRed(right.root)) {
+      right.root->color = kBlack;
+      right.height++;
+    }
+    if (left.height == right.height) return Make(left, node, right, kRed);
+
+    subtree result{left.height > right.height ? JoinRight(left, node, right)
+                                              : JoinLeft(left, node, right)};
+    node_base* top{result.root};
+    if (IsRed(top) && (IsRed(top->left) || IsRed(top->right))) {
+      top->color = kBlack;
+      result.height++;
+    }
+    return result;
+  }
+
+  // takes the last node out of a non-empty tree
+  static subtree SplitLast(const subtree& tree, node_base*& last) {
+    if (!tree.root->right) {
+      last = tree.root;
+      return LeftOf(tree);
+    }
+    subtree rest{SplitLast(RightOf(tree), last)};
+    return Join(LeftOf(tree), tree.root, rest);
+  }
+
+  static subtree Join(const subtree& left, const subtree& right) {
+    if (!left.root) return right;
+    if (!right.root) return left;
+
+    node_base* last{nullptr};
+    subtree rest{SplitLast(left, last)};
+    return Join(rest, last, right);
+  }
+
+  // the keys before key and the rest; with upper the keys equal to key go
+  // to the first part instead
+  std::pair<subtree, subtree> Split(const subtree& tree, const key_type& key,
+                                    bool upper) const {
+    if (!tree.root) return {tree, tree};
+
+    node_base* node{tree.root};
+    bool after{upper ? Less(key, KeyOf(node)) : !Less(KeyOf(node), key)};
+    if (after) {
+      std::pair<subtree, subtree> parts{Split(LeftOf(tree), key, upper)};
+      parts.second = Join(parts.second, node, RightOf(tree));
+      return parts;
+    }
+    std::pair<subtree, subtree> parts{Split(RightOf(tree), key, upper)};
+    parts.first = Join(LeftOf(tree), node, parts.first);
+    return parts;
+  }
+
+  // cuts the tree into the keys less than, equal to and greater than key
+  void Split(const subtree& tree, const key_type& key, bool duplicate,
+             subtree& less, subtree& equal, subtree& greater) const {
+    if (!tree.root) {
+      less = equal = greater = tree;
+      return;
+    }
+
+    node_base* node{tree.root};
+    if (Less(key, KeyOf(node))) {
+      Split(LeftOf(tree), key, duplicate, less, equal, greater);
+      greater = Join(greater, node, RightOf(tree));
+    } else if (Less(KeyOf(node), key)) {
+      Split(RightOf(tree), key, duplicate, less, equal, greater);
+      less = Join(LeftOf(tree), node, less);
+    } else if (!duplicate) {
+      less = LeftOf(tree);
+      greater = RightOf(tree);
+      equal = Make(subtree{nullptr, 0}, node, subtree{nullptr, 0}, kBlack);
+    } else {
+      std::pair<subtree, subtree> left{Split(LeftOf(tree), key, false)};
+      std::pair<subtree, subtree> right{Split(RightOf(tree), key, true)};
+      less = left.first;
+      greater = right.second;
+      equal = Join(left.second, node, right.first);
+    }
+  }
+
+  // the nodes of a tree in order, chained through their right links
+  static run Chain(const subtree& tree) {
+    run result{nullptr, 0};
+    node_base** tail{&result.head};
+    node_base* stack[2 * std::numeric_limits<size_type>::digits];
+    size_type top{0};
+    node_base* current{tree.root};
+    while (current || top) {
+      for (; current; current = current->left) stack[top++] = current;
+      current = stack[--top];
+      node_base* next{current->right};
+      *tail = current;
+      tail = &current->right;
+      result.count++;
+      current = next;
+    }
+    *tail = nullptr;
+    return result;
+  }
+
+  // moves the first count nodes of the run into the ledger
+  static void DropFront(run& nodes, size_type count, ledger& dropped) {
+    for (; count; --count) {
+      node_base* node{nodes.head};
+      nodes.head = node->right;
+      nodes.count--;
+      node->left = node->right = nullptr;
+      Drop(node, dropped);
+    }
+  }
+
+  // moves all but the first count nodes of the run into the ledger
+  static void DropBack(run& nodes, size_type count, ledger& dropped) {
+    node_base** tail{&nodes.head};
+    for (size_type i = 0; i < count; ++i) tail = &(*tail)->right;
+    node_base* rest{*tail};
+    *tail = nullptr;
+    run extra{rest, nodes.count - count};
+    nodes.count = count;
+    DropFront(extra, extra.count, dropped);
+  }
+
+  static void Drop(node_base* root, ledger& dropped) {
+    root->parent = nullptr;
+    (dropped.tail ? dropped.tail->parent : dropped.head) = root;
+    dropped.tail = root;
+  }
+
+  static void Append(ledger& dropped, const ledger& more) {
+    if (!more.head) return;
+    (dropped.tail ? dropped.tail->parent : dropped.head) = more.head;
+    dropped.tail = more.tail;
+  }
+
+  // destroys the dropped subtrees and returns how many nodes they had
+  size_type DestroyDropped(const ledger& dropped) {
+    size_type count{0};
+    for (node_base* root = dropped.head; root;) {
+      node_base* next{root->parent};
+      count += DestroySubtree(root);
+      root = next;
+    }
+    return count;
+  }
+
+  // left, the run and right as one tree
+  static subtree Join(const subtree& left, run& nodes, const subtree& right) {
+    if (!nodes.count) return Join(left, right);
+
+    node_base* last{nodes.head};
+    for (size_type i = 1; i < nodes.count; ++i) last = last->right;
+    subtree middle{nullptr, 0};
+    if (nodes.count > 1) {
+      middle.root =
+          LinkSorted(nodes.head, nodes.count - 1, 0, RedDepth(nodes.count - 1));
+      for (const node_base* node = middle.root; node; node = node->left)
+        middle.height += node->color == kBlack;
+    }
+    return Join(Join(left, middle), last, right);
+  }
+
+  // runs left and right, on two threads if there are threads to spare,
+  // each with a ledger of its own
+  template <class Left, class Right>
+  static void Fork(size_type threads, ledger& dropped, Left left,
+                   Right right) {
+    ledger more{};
+    parallel::Fork(
+        threads > 1, [&] { left(threads / 2, dropped); },
+        [&] { right(threads - threads / 2, more); });
+    Append(dropped, more);
+  }
+
+  // both trees are consumed; of equal keys the ones of mine come first and
+  // theirs only add what mine lack
+  subtree Unite(const subtree& mine, const subtree& theirs, bool duplicate,
+                size_type threads, ledger& dropped) const {
+    if (!mine.root) return theirs;
+    if (!theirs.root) return mine;
+
+    const key_type& key{KeyOf(theirs.root)};
+    subtree mine_less, mine_equal, mine_greater;
+    Split(mine, key, duplicate, mine_less, mine_equal, mine_greater);
+    subtree their_less, their_equal, their_greater;
+    Split(theirs, key, duplicate, their_less, their_equal, their_greater);
+
+    subtree left, right;
+    Fork(
+        threads, dropped,
+        [&](size_type share, ledger& drop) {
+          left = Unite(mine_less, their_less, duplicate, share, drop);
+        },
+        [&](size_type share, ledger& drop) {
+          right = Unite(mine_greater, their_greater, duplicate, share, drop);
+        });
+
+    run kept{Chain(mine_equal)};
+    run added{Chain(their_equal)};
+    DropFront(added, std::min(kept.count, added.count), dropped);
+    if (added.count) {
+      node_base** tail{&kept.head};
+      while (*tail) tail = &(*tail)->right;
+      *tail = added.head;
+      kept.count += added.count;
+    }
+    return Join(left, kept, right);
+  }
+
+  // the number of keys equal to key under node
+  size_type CountEqual(const node_base* node, const key_type& key) const {
+    if (!node) return 0;
+    if (Less(key, KeyOf(node))) return CountEqual(node->left, key);
+    if (Less(KeyOf(node), key)) return CountEqual(node->right, key);
+    return 1 + CountEqual(node->left, key) + CountEqual(node->right, key);
+  }
+
+  // mine is consumed, theirs is the root of the other tree and only read
+  subtree Intersect(const subtree& mine, const node_base* theirs,
+                    bool duplicate, size_type threads, ledger& dropped) const {
+    if (!mine.root) return mine;
+    if (!theirs) {
+      Drop(mine.root, dropped);
+      return subtree{nullptr, 0};
+    }
+
+    const key_type& key{KeyOf(theirs)};
+    subtree less, equal, greater;
+    Split(mine, key, duplicate, less, equal, greater);
+
+    subtree left, right;
+    Fork(
+        threads, dropped,
+        [&](size_type share, ledger& drop) {
+          left = Intersect(less, theirs->left, duplicate, share, drop);
+        },
+        [&](size_type share, ledger& drop) {
+          right = Intersect(greater, theirs->right, duplicate, share, drop);
+        });
+
+    run kept{Chain(equal)};
+    if (kept.count) {
+      size_type count{duplicate ? CountEqual(theirs, key) : 1};
+      if (count < kept.count) DropBack(kept, count, dropped);
+    }
+    return Join(left, kept, right);
+  }
+
+  // mine is consumed, theirs is the root of the other tree and only read
+  subtree Subtract(const subtree& mine, const node_base* theirs,
+                   bool duplicate, size_type threads, ledger& dropped) const {
+    if (!mine.root || !theirs) return mine;
+
+    const key_type& key{KeyOf(theirs)};
+    subtree less, equal, greater;
+    Split(mine, key, duplicate, less, equal, greater);
+
+    subtree left, right;
+    Fork(
+        threads, dropped,
+        [&](size_type share, ledger& drop) {
+          left = Subtract(less, theirs->left, duplicate, share, drop);
+        },
+        [&](size_type share, ledger& drop) {
+          right = Subtract(greater, theirs->right, duplicate, share, drop);
+        });
+
+    run kept{Chain(equal)};
+    if (kept.count) {
+      size_type count{duplicate ? CountEqual(theirs, key) : 1};
+      DropFront(kept, std::min(count, kept.count), dropped);
+    }
+    return Join(left, kept, right);
+  }
+
+  // a whole subtree, or a single node between two of them
+  struct piece {
+    const node_base* node;
+    bool whole;
+  };
+
+  // the pieces that cover the tree in order, for threads threads (which
+  // is set to the actual number first)
+  std::vector<piece> Cut(size_type& threads) const {
+    threads = parallel::Threads(threads);
+    std::vector<piece> pieces;
+    if (!header_.parent) return pieces;
+    if (threads == 1 || nodes_count_ < 2 * parallel::kGrain) {
+      pieces.push_back(piece{header_.parent, true});
+      return pieces;
+    }
+
+    // the levels are at most twice as deep as the shortest path, so one
+    // level more than a perfect tree would need evens out the skew
+    size_type wanted{threads * 8};
+    size_type depth{1};
+    while ((size_type{1} << (depth - 1)) < wanted) depth++;
+    Cut(header_.parent, depth, nodes_count_ / wanted, pieces);
+    return pieces;
+  }
+
+  void Cut(const node_base* node, size_type depth, size_type grain,
+           std::vector<piece>& pieces) const {
+    if (!node) return;
+
+    bool split{false};
+    if constexpr (Ranked) {
+      (void)depth;
+      split = SizeOf(node) > grain;
+    } else {
+      (void)grain;
+      split = depth > 0;
+    }
+    if (!split) {
+      pieces.push_back(piece{node, true});
+      return;
+    }
+    Cut(node->left, depth - 1, grain, pieces);
+    pieces.push_back(piece{node, false});
+    Cut(node->right, depth - 1, grain, pieces);
+  }
+
+  // an in-order walk of a piece on an explicit stack; a red-black tree is
+  // at most twice as high as the bits of its size
+  template <class Function>
+  static void Walk(const piece& part, Function&& f) {
+    if (!part.whole) {
+      f(AsNode(part.node)->data);
+      return;
+    }
+
+    const node_base* stack[2 * std::numeric_limits<size_type>::digits];
+    size_type top{0};
+    const node_base* current{part.node};
+    while (current || top) {
+      for (; current; current = current->left) stack[top++] = current;
+      current = stack[--top];
+      f(AsNode(current)->data);
+      current = current->right;
+    }
+  }
+
+  // LinkSorted over an array of nodes: the same shape and colors, but the
+  // two subtrees of a node are independent and big ones are linked on
+  // threads of their own
+  static node_base* LinkNodes(tree_node* const* nodes, size_type count,
+                              size_type depth, size_type red_depth,
+                              size_type threads) {
+    if (!count) return nullptr;
+
+    size_type left_count{(count - 1) / 2};
+    node_base* node{nodes[left_count]};
+    node_base* left{nullptr};
+    node_base* right{nullptr};
+    parallel::Fork(
+        threads > 1 && count >= 2 * parallel::kGrain,
+        [&] {
+          left = LinkNodes(nodes, left_count, depth + 1, red_depth,
+                           threads / 2);
+        },
+        [&] {
+          right = LinkNodes(nodes + left_count + 1, count - 1 - left_count,
+                            depth + 1, red_depth, threads - threads / 2);
+        });
+
+    node->left = left;
+    node->right = right;
+    if (left) left->parent = node;
+    if (right) right->parent = node;
+    node->color = depth == red_depth ? kRed : kBlack;
+    Resize(node);
+    return node;
+  }
+
+  static size_type SizeOf(const node_base* node) {
+    if constexpr (Ranked) {
+      return node ? AsNode(node)->size : 0;
+    } else {
+      return 0;
+    }
+  }
+
+  // recomputes the size of a node from its children
+  static void Resize(node_base* node) {
+    if constexpr (Ranked)
+      AsNode(node)->size = SizeOf(node->left) + SizeOf(node->right) + 1;
+  }
+
+  static bool IsRed(const node_base* node) {
+    return node && node->color == kRed;
+  }
+
+  static bool IsBlack(const node_base* node) { return !IsRed(node); }
+
+  // hangs "to" where "from" was, the root hangs off the header
+  void ReplaceChild(node_base* from, node_base* to) {
+    if (from == header_.parent) {
+      header_.parent = to;
+    } else if (from == from->parent->left) {
+      from->parent->left = to;
+    } else {
+      from->parent->right = to;
+    }
+  }
+
+  void RotateLeft(node_base* node) {
+    node_base* pivot{node->right};
+    node->right = pivot->left;
+    if (pivot->left) pivot->left->parent = node;
+
+    pivot->parent = node->parent;
+    ReplaceChild(node, pivot);
+    pivot->left = node;
+    node->parent = pivot;
+    Resize(node);
+    Resize(pivot);
+  }
+
+  void RotateRight(node_base* node) {
+    node_base* pivot{node->left};
+    node->left = pivot->right;
+    if (pivot->right) pivot->right->parent = node;
+
+    pivot->parent = node->parent;
+    ReplaceChild(node, pivot);
+    pivot->right = node;
+    node->parent = pivot;
+    Resize(node);
+    Resize(pivot);
+  }
+
+  // restores the red-black properties after linking a red leaf
+  void InsertFixup(node_base* node) {
+    while (node != header_.parent && IsRed(node->parent)) {
+      node_base* parent{node->parent};
+      node_base* grandparent{parent->parent};
+      if (parent == grandparent->left) {
+        node_base* uncle{grandparent->right};
+        if (IsRed(uncle)) {
+          parent->color = kBlack;
+          uncle->color = kBlack;
+          grandparent->color = kRed;
+          node = grandparent;
+        } else {
+          if (node == parent->right) {
+            node = parent;
+            RotateLeft(node);
+            parent = node->parent;
+          }
+          parent->color = kBlack;
+          grandparent->color = kRed;
+          RotateRight(grandparent);
+        }
       } else {
-        tree_node* successor{FindMin(current->right)};
-        current->data = successor->data;
-        current->right = RemoveNode(current->right, successor->data);
+        node_base* uncle{grandparent->left};
+        if (IsRed(uncle)) {
+          parent->color = kBlack;
+          uncle->color = kBlack;
+          grandparent->color = kRed;
+          node = grandparent;
+        } else {
+          if (node == parent->left) {
+            node = parent;
+            RotateRight(node);
+            parent = node->parent;
+          }
+          parent->color = kBlack;
+          grandparent->color = kRed;
+          RotateLeft(grandparent);
+        }
       }
-      nodes_count_--;
     }
+    header_.parent->color = kBlack;
+  }
+
+  static node_base* FindMin(node_base* current) {
+    while (current->left) current = current->left;
+    return current;
+  }
+
+  static node_base* FindMax(node_base* current) {
+    while (current->right) current = current->right;
     return current;
   }
 
-  RBtree::tree_node* FindNodeByKey(tree_node* current, key_type data) {
-    if (!current || data == current->data) {
-      return current;
-    } else if (data < current->data) {
-      return FindNodeByKey(current->left, data);
+  // puts the subtree "to" in place of the subtree "from"
+  void Transplant(node_base* from, node_base* to) {
+    ReplaceChild(from, to);
+    if (to) to->parent = from->parent;
+  }
+
+  void RemoveNode(tree_node* node) {
+    UnlinkNode(node);
+    DestroyNode(node);
+  }
+
+  // detaches the node by relinking its neighbours, so iterators to the
+  // other nodes stay valid; the node itself is left untouched
+  void UnlinkNode(node_base* node) {
+    if (node == header_.left)
+      header_.left = node->right ? FindMin(node->right) : node->parent;
+    if (node == header_.right)
+      header_.right = node->left ? FindMax(node->left) : node->parent;
+
+    // a node with two children is replaced by its successor, so the tree
+    // loses a node where the successor was
+    if constexpr (Ranked) {
+      node_base* removed{node->left && node->right ? FindMin(node->right)
+                                                   : node};
+      for (node_base* above{removed->parent}; above != &header_;
+           above = above->parent)
+        AsNode(above)->size--;
+    }
+
+    node_base* child{nullptr};
+    node_base* child_parent{nullptr};
+    Color removed_color{node->color};
+
+    if (!node->left) {
+      child = node->right;
+      child_parent = node->parent;
+      Transplant(node, node->right);
+    } else if (!node->right) {
+      child = node->left;
+      child_parent = node->parent;
+      Transplant(node, node->left);
     } else {
-      return FindNodeByKey(current->right, data);
+      node_base* successor{FindMin(node->right)};
+      removed_color = successor->color;
+      child = successor->right;
+      if (successor->parent == node) {
+        child_parent = successor;
+      } else {
+        child_parent = successor->parent;
+        Transplant(successor, successor->right);
+        successor->right = node->right;
+        successor->right->parent = successor;
+      }
+      Transplant(node, successor);
+      successor->left = node->left;
+      successor->left->parent = successor;
+      successor->color = node->color;
+      Resize(successor);
+    }
+
+    nodes_count_--;
+    if (removed_color == kBlack) EraseFixup(child, child_parent);
+  }
+
+  // pushes the extra black of "node" up the tree or absorbs it with
+  // rotations; "node" may be null, so its parent is passed explicitly
+  void EraseFixup(node_base* node, node_base* parent) {
+    while (node != header_.parent && IsBlack(node)) {
+      if (node == parent->left) {
+        node_base* sibling{parent->right};
+        if (IsRed(sibling)) {
+          sibling->color = kBlack;
+          parent->color = kRed;
+          RotateLeft(parent);
+          sibling = parent->right;
+        }
+        if (IsBlack(sibling->left) && IsBlack(sibling->right)) {
+          sibling->color = kRed;
+          node = parent;
+          parent = node->parent;
+        } else {
+          if (IsBlack(sibling->right)) {
+            sibling->left->color = kBlack;
+            sibling->color = kRed;
+            RotateRight(sibling);
+            sibling = parent->right;
+          }
+          sibling->color = parent->color;
+          parent->color = kBlack;
+          sibling->right->color = kBlack;
+          RotateLeft(parent);
+          node = header_.parent;
+        }
+      } else {
+        node_base* sibling{parent->left};
+        if (IsRed(sibling)) {
+          sibling->color = kBlack;
+          parent->color = kRed;
+          RotateRight(parent);
+          sibling = parent->left;
+        }
+        if (IsBlack(sibling->left) && IsBlack(sibling->right)) {
+          sibling->color = kRed;
+          node = parent;
+          parent = node->parent;
+        } else {
+          if (IsBlack(sibling->left)) {
+            sibling->right->color = kBlack;
+            sibling->color = kRed;
+            RotateLeft(sibling);
+            sibling = parent->left;
+          }
+          sibling->color = parent->color;
+          parent->color = kBlack;
+          sibling->left->color = kBlack;
+          RotateRight(parent);
+          node = header_.parent;
+        }
+      }
+    }
+    if (node) node->color = kBlack;
+  }
+
+  // returns the black height of the subtree or -1 if it breaks an invariant
+  int BlackHeight(const node_base* node) const {
+    if (!node) return 1;
+
+    if (node->left &&
+        (node->left->parent != node || Less(KeyOf(node), KeyOf(node->left))))
+      return -1;
+    if (node->right && (node->right->parent != node ||
+                        Less(KeyOf(node->right), KeyOf(node))))
+      return -1;
+    if (IsRed(node) && (IsRed(node->left) || IsRed(node->right))) return -1;
+    if (Ranked &&
+        SizeOf(node) != SizeOf(node->left) + SizeOf(node->right) + 1)
+      return -1;
+
+    int left{BlackHeight(node->left)};
+    int right{BlackHeight(node->right)};
+    if (left == -1 || left != right) return -1;
+
+    return left + (node->color == kBlack);
+  }
+
+  // the descents keep the last node on the far side of the key with one
+  // comparison per level; the header stands for "no such node"
+  template <class K>
+  node_base* LowerBound(const K& key) const {
+    node_base* current{header_.parent};
+    node_base* bound{const_cast<node_base*>(&header_)};
+    while (current) {
+      if (!Less(KeyOf(current), key)) {
+        bound = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
     }
+    return bound;
+  }
+
+  template <class K>
+  node_base* UpperBound(const K& key) const {
+    node_base* current{header_.parent};
+    node_base* bound{const_cast<node_base*>(&header_)};
+    while (current) {
+      if (Less(key, KeyOf(current))) {
+        bound = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    return bound;
+  }
+
+  template <class K>
+  size_type CountKey(const K& key) const {
+    size_type count{0};
+    for (iterator it{lower_bound(key)};
+         it.current != &header_ && !Less(key, KeyOf(it.current)); ++it)
+      count++;
+    return count;
+  }
+
+  template <class K>
+  size_type Rank(const K& key) const {
+    static_assert(Ranked, "s21::RBtree: rank needs a ranked tree");
+    size_type less{0};
+    node_base* current{header_.parent};
+    while (current) {
+      if (Less(KeyOf(current), key)) {
+        less += SizeOf(current->left) + 1;
+        current = current->right;
+      } else {
+        current = current->left;
+      }
+    }
+    return less;
+  }
+
+  template <class K>
+  size_type CountRange(const K& low, const K& high) const {
+    size_type below_low{Rank(low)};
+    size_type below_high{Rank(high)};
+    return below_high > below_low ? below_high - below_low : 0;
+  }
+
+  // returns the first node in order holding the key, since rotations may put
+  // duplicates on both sides of an equal node; equality is checked once at
+  // the bottom
+  template <class K>
+  node_base* FindNodeByKey(const K& key) const {
+    node_base* bound{LowerBound(key)};
+    if (bound == &header_ || Less(key, KeyOf(bound))) return nullptr;
+    return bound;
   }
 
 };  // class RBtree
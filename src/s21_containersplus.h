@@ -2,6 +2,15 @@
 #define SRC_s_CONTAINERSPLUS_H
 
 #include "implementations/s_array.h"
+#include "implementations/s_btree_map.h"
+#include "implementations/s_btree_multiset.h"
+#include "implementations/s_concurrent_map.h"
+#include "implementations/s_counted_multiset.h"
+#include "implementations/s_flat_map.h"
+#include "implementations/s_flat_multiset.h"
 #include "implementations/s_multiset.h"
+#include "implementations/s_persistent_set.h"
+#include "implementations/s_unordered_map.h"
+#include "implementations/s_unordered_set.h"
 
 #endif  // SRC_s_CONTAINERSPLUS_H_
\ No newline at end of file
@@ -1,12 +1,25 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
+#include <sstream>
 #include <stack>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "s_containers.h"
@@ -1150,6 +1163,16 @@ TEST(s_array_test, swap) {
   ASSERT_EQ(*arr.begin(), 7);
 }
 
+struct counted_key {
+  static size_t compares;
+  int value;
+  bool operator<(const counted_key& other) const {
+    ++compares;
+    return value < other.value;
+  }
+};
+size_t counted_key::compares = 0;
+
 TEST(set_test, constr1_unique) {
   s21::set<int> s1 = {24, 5, 6, 2, 7, 33, 8, 9, 10};
   std::set<int> s2 = {24, 5, 6, 2, 7, 33, 8, 9, 10};
@@ -1230,6 +1253,36 @@ TEST(set_test, operator_assaignment_copy_self) {
     EXPECT_EQ(*it1, *it2);
 }
 
+TEST(set_test, copy_structure) {
+  s21::set<counted_key> s1;
+  for (int i = 0; i < 5000; ++i) s1.insert(counted_key{i * 7 % 5003});
+  counted_key::compares = 0;
+  s21::set<counted_key> s2(s1);
+  s21::set<counted_key> s3 = {counted_key{1}};
+  s3 = s1;
+  EXPECT_EQ(counted_key::compares, 0U);
+  EXPECT_EQ(s2.size(), s1.size());
+  EXPECT_EQ(s3.size(), s1.size());
+  EXPECT_TRUE(s2.CheckBalance());
+  EXPECT_TRUE(s3.CheckBalance());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(it1->value, it2->value);
+}
+
+TEST(set_test, operator_assaignment_copy_clears) {
+  s21::set<std::string> s1 = {"a", "b", "c"};
+  s21::set<std::string> s2;
+  s1 = s2;
+  EXPECT_TRUE(s1.empty());
+  EXPECT_EQ(s1.begin(), s1.end());
+  s2.insert("d");
+  s1 = s2;
+  s2.erase(s2.begin());
+  EXPECT_EQ(s1.size(), 1U);
+  EXPECT_EQ(*s1.begin(), "d");
+}
+
 TEST(set_test, operator_assaignment_move) {
   s21::set<int> s3 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 9, 10};
   std::set<int> s2 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 9, 10};
@@ -1256,6 +1309,24 @@ TEST(set_test, begin) {
   EXPECT_EQ(*it1, 2);
 }
 
+TEST(set_test, end_decrement) {
+  s21::set<int> s1 = {24, 5, 6, 2, 7, 33, 8, 9, 10};
+  std::set<int> s2 = {24, 5, 6, 2, 7, 33, 8, 9, 10};
+  auto it1 = s1.end();
+  for (auto it2 = s2.end(); it2 != s2.begin();) EXPECT_EQ(*--it1, *--it2);
+  EXPECT_EQ(it1, s1.begin());
+}
+
+TEST(set_test, begin_end_empty) {
+  s21::set<int> s1;
+  EXPECT_EQ(s1.begin(), s1.end());
+  EXPECT_EQ(--s1.end(), s1.end());
+  s1.insert(1);
+  s1.erase(s1.begin());
+  EXPECT_EQ(s1.begin(), s1.end());
+  EXPECT_TRUE(s1.CheckBalance());
+}
+
 TEST(set_test, empty_false) {
   s21::set<int> s1 = {24, 5, 6, 2, 7, 33, 8, 9, 10};
   std::set<int> s2 = {24, 5, 6, 2, 7, 33, 8, 9, 10};
@@ -1299,6 +1370,285 @@ TEST(set_test, insert) {
     EXPECT_EQ(*it1, *it2);
 }
 
+TEST(set_test, insert_result) {
+  s21::set<int> s1 = {1, 3, 5};
+  auto res1 = s1.insert(4);
+  EXPECT_TRUE(res1.second);
+  EXPECT_EQ(*res1.first, 4);
+  EXPECT_EQ(*--res1.first, 3);
+  auto res2 = s1.insert(5);
+  EXPECT_FALSE(res2.second);
+  EXPECT_EQ(res2.first, s1.find(5));
+  EXPECT_EQ(s1.size(), 4U);
+}
+
+TEST(set_test, emplace) {
+  s21::set<std::string> s1;
+  auto res1 = s1.emplace(3, 'x');
+  EXPECT_TRUE(res1.second);
+  EXPECT_EQ(*res1.first, "xxx");
+  auto res2 = s1.emplace("xxx");
+  EXPECT_FALSE(res2.second);
+  EXPECT_EQ(res2.first, res1.first);
+  EXPECT_EQ(s1.size(), 1U);
+}
+
+TEST(set_test, insert_hint_sorted) {
+  s21::set<counted_key> s1;
+  counted_key::compares = 0;
+  for (int i = 0; i < 10000; ++i) s1.insert(s1.end(), counted_key{i});
+  EXPECT_LT(counted_key::compares, 3U * 10000);
+  EXPECT_EQ(s1.size(), 10000U);
+  EXPECT_TRUE(s1.CheckBalance());
+  int expected = 0;
+  for (auto it = s1.begin(); it != s1.end(); ++it)
+    EXPECT_EQ(it->value, expected++);
+}
+
+TEST(set_test, insert_hint_wrong) {
+  s21::set<int> s1 = {10, 20, 30, 40};
+  std::set<int> s2 = {10, 20, 30, 40};
+  auto it = s1.insert(s1.begin(), 35);
+  EXPECT_EQ(*it, 35);
+  it = s1.insert(s1.find(30), 25);
+  EXPECT_EQ(*it, 25);
+  it = s1.insert(s1.end(), 5);
+  EXPECT_EQ(*it, 5);
+  it = s1.emplace_hint(s1.find(40), 20);
+  EXPECT_EQ(it, s1.find(20));
+  s2.insert({35, 25, 5});
+  EXPECT_EQ(s1.size(), s2.size());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+  EXPECT_TRUE(s1.CheckBalance());
+}
+
+TEST(set_test, build_from_sorted) {
+  std::vector<int> keys;
+  for (int n = 0; n < 70; ++n) {
+    s21::set<int> s1 = {-1};
+    s1.build_from_sorted(keys.begin(), keys.end());
+    EXPECT_EQ(s1.size(), keys.size());
+    EXPECT_TRUE(s1.CheckBalance());
+    EXPECT_TRUE(std::equal(keys.begin(), keys.end(), s1.begin()));
+    keys.push_back(n);
+  }
+}
+
+TEST(set_test, build_from_sorted_duplicates) {
+  std::vector<int> keys = {1, 1, 2, 3, 3, 3, 7};
+  s21::set<int> s1;
+  s1.build_from_sorted(keys.begin(), keys.end());
+  EXPECT_EQ(s1.size(), 4U);
+  EXPECT_TRUE(s1.CheckBalance());
+  s1.insert(5);
+  EXPECT_EQ(*--s1.end(), 7);
+  std::vector<int> unsorted = {1, 3, 2};
+  EXPECT_THROW(s1.build_from_sorted(unsorted.begin(), unsorted.end()),
+               std::invalid_argument);
+}
+
+TEST(set_test, constr_single_pass_range) {
+  std::istringstream unsorted("5 1 4 1 3");
+  s21::set<int> s1{std::istream_iterator<int>(unsorted),
+                   std::istream_iterator<int>()};
+  EXPECT_EQ(s1.size(), 4U);
+  std::vector<int> expected{1, 3, 4, 5};
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), s1.begin()));
+
+  std::istringstream sorted("1 2 2 3");
+  s21::multiset<int> s2{std::istream_iterator<int>(sorted),
+                        std::istream_iterator<int>()};
+  EXPECT_EQ(s2.size(), 4U);
+  EXPECT_EQ(s2.count(2), 2U);
+
+  std::istringstream again("6 7 8");
+  s2.build_from_sorted(std::istream_iterator<int>(again),
+                       std::istream_iterator<int>());
+  EXPECT_EQ(s2.size(), 3U);
+  EXPECT_EQ(*s2.begin(), 6);
+  EXPECT_TRUE(s2.CheckBalance());
+}
+
+TEST(set_test, from_unsorted) {
+  std::vector<int> keys;
+  unsigned seed{7};
+  for (int i = 0; i < 100000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    keys.push_back(static_cast<int>(seed >> 8) % 60000);
+  }
+  std::set<int> origin(keys.begin(), keys.end());
+  for (size_t threads : {1, 3, 4}) {
+    s21::set<int> s1 = s21::set<int>::from_unsorted(keys.begin(), keys.end(),
+                                                   threads);
+    EXPECT_EQ(s1.size(), origin.size());
+    EXPECT_TRUE(s1.CheckBalance());
+    EXPECT_TRUE(std::equal(origin.begin(), origin.end(), s1.begin()));
+  }
+}
+
+TEST(set_test, from_unsorted_small) {
+  std::vector<int> keys;
+  for (int n = 0; n < 70; ++n) {
+    s21::ranked_set<int> s1 =
+        s21::ranked_set<int>::from_unsorted(keys.begin(), keys.end(), 2);
+    EXPECT_EQ(s1.size(), keys.size());
+    EXPECT_TRUE(s1.CheckBalance());
+    for (int i = 0; i < n; ++i) EXPECT_EQ(*s1.nth(i), i);
+    keys.insert(keys.begin() + n / 2, n);
+    std::sort(keys.begin(), keys.end(), std::greater<int>());
+  }
+}
+
+TEST(set_test, parallel_for_each) {
+  s21::set<int> s1;
+  for (int i = 0; i < 100000; ++i) s1.insert(i * 7919 % 100003);
+  for (size_t threads : {1, 2, 5}) {
+    std::atomic<long long> sum{0};
+    std::atomic<int> calls{0};
+    s1.parallel_for_each(
+        [&](int key) {
+          sum += key;
+          calls++;
+        },
+        threads);
+    EXPECT_EQ(calls, 100000);
+    long long expected{0};
+    for (auto it = s1.begin(); it != s1.end(); ++it) expected += *it;
+    EXPECT_EQ(sum, expected);
+  }
+  s21::set<int> empty;
+  empty.parallel_for_each([](int) { FAIL(); }, 4);
+}
+
+TEST(set_test, parallel_reduce_ordered) {
+  s21::ranked_set<int> s1;
+  for (int i = 0; i < 100000; ++i) s1.insert(i * 7919 % 100003);
+  // concatenation is associative but does not commute
+  auto append = [](std::vector<int> keys, int key) {
+    keys.push_back(key);
+    return keys;
+  };
+  auto join = [](std::vector<int> left, const std::vector<int> &right) {
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+  };
+  std::vector<int> keys{
+      s1.parallel_reduce(std::vector<int>(), append, join, 4)};
+  EXPECT_EQ(keys.size(), 100000U);
+  EXPECT_TRUE(std::equal(keys.begin(), keys.end(), s1.begin()));
+
+  bool all_even{s1.parallel_reduce(
+      true, [](bool even, int key) { return even && key % 2 == 0; },
+      [](bool a, bool b) { return a && b; }, 3)};
+  EXPECT_FALSE(all_even);
+}
+
+TEST(set_test, parallel_reduce_throws) {
+  s21::set<int> s1;
+  for (int i = 0; i < 100000; ++i) s1.insert(i);
+  EXPECT_THROW(s1.parallel_reduce(
+                   0,
+                   [](int count, int key) {
+                     if (key == 77777) throw std::out_of_range("key");
+                     return count + 1;
+                   },
+                   [](int a, int b) { return a + b; }, 4),
+               std::out_of_range);
+}
+
+TEST(set_test, set_algebra) {
+  unsigned seed{3};
+  for (int round = 0; round < 200; ++round) {
+    std::set<int> a;
+    std::set<int> b;
+    for (int i = 0; i < round % 50; ++i) {
+      seed = seed * 1103515245 + 12345;
+      a.insert(static_cast<int>(seed >> 16) % 80);
+      seed = seed * 1103515245 + 12345;
+      b.insert(static_cast<int>(seed >> 16) % 80);
+    }
+    std::vector<int> united, common, rest;
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                   std::back_inserter(united));
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(common));
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(rest));
+
+    s21::set<int> s1(a.begin(), a.end());
+    s21::set<int> s2(b.begin(), b.end());
+    s21::set<int> u{s21::set_union(s1, s2)};
+    s21::set<int> i{s21::set_intersection(s1, s2)};
+    s21::set<int> d{s21::set_difference(s1, s2)};
+    EXPECT_EQ(u.size(), united.size());
+    EXPECT_EQ(i.size(), common.size());
+    EXPECT_EQ(d.size(), rest.size());
+    EXPECT_TRUE(u.CheckBalance() && i.CheckBalance() && d.CheckBalance());
+    EXPECT_TRUE(std::equal(united.begin(), united.end(), u.begin()));
+    EXPECT_TRUE(std::equal(common.begin(), common.end(), i.begin()));
+    EXPECT_TRUE(std::equal(rest.begin(), rest.end(), d.begin()));
+    EXPECT_EQ(s1.size(), a.size());
+    EXPECT_EQ(s2.size(), b.size());
+
+    // rvalues are taken over instead of copied
+    s21::set<int> moved{
+        s21::set_union(s21::set<int>(s1), s21::set<int>(s2))};
+    EXPECT_EQ(moved.size(), united.size());
+    moved = s21::set_difference(std::move(moved), s2);
+    EXPECT_EQ(moved.size(), rest.size());
+    EXPECT_TRUE(std::equal(rest.begin(), rest.end(), moved.begin()));
+  }
+}
+
+TEST(set_test, set_algebra_in_place_parallel) {
+  s21::ranked_set<int> s1;
+  s21::ranked_set<int> s2;
+  for (int i = 0; i < 60000; ++i) {
+    s1.insert(i * 3);
+    s2.insert(i * 5);
+  }
+  s21::ranked_set<int> common{s1};
+  common.intersect(s2, 4);
+  EXPECT_EQ(common.size(), 12000U);
+  EXPECT_TRUE(common.CheckBalance());
+  EXPECT_EQ(*common.nth(100), 1500);
+
+  s21::ranked_set<int> rest{s1};
+  rest.subtract(s2, 4);
+  EXPECT_EQ(rest.size(), 48000U);
+  EXPECT_TRUE(rest.CheckBalance());
+  EXPECT_FALSE(rest.contains(15));
+  EXPECT_TRUE(rest.contains(18));
+
+  s1.unite(std::move(s2), 4);
+  EXPECT_EQ(s1.size(), 108000U);
+  EXPECT_TRUE(s2.empty());
+  EXPECT_TRUE(s1.CheckBalance());
+  EXPECT_EQ(s1.rank(15), 7U);
+  s1.insert(-1);
+  EXPECT_EQ(*s1.begin(), -1);
+
+  rest.subtract(rest);
+  EXPECT_TRUE(rest.empty());
+}
+
+TEST(set_test, constr_range) {
+  std::vector<int> sorted(100000);
+  for (int i = 0; i < 100000; ++i) sorted[i] = i * 2;
+  s21::set<int> s1(sorted.begin(), sorted.end());
+  EXPECT_EQ(s1.size(), sorted.size());
+  EXPECT_TRUE(s1.CheckBalance());
+  EXPECT_TRUE(s1.contains(1000));
+  EXPECT_FALSE(s1.contains(1001));
+  std::vector<int> unsorted = {5, 1, 4, 1, 3};
+  s21::set<int> s2(unsorted.begin(), unsorted.end());
+  std::set<int> s3(unsorted.begin(), unsorted.end());
+  EXPECT_EQ(s2.size(), s3.size());
+  EXPECT_TRUE(std::equal(s3.begin(), s3.end(), s2.begin()));
+}
+
 TEST(set_test, swap) {
   s21::set<int> s1 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 9};
   std::set<int> s2 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 9};
@@ -1364,6 +1714,192 @@ TEST(set_test, merge_duplicate) {
     EXPECT_EQ(*it3, *it4);
 }
 
+TEST(set_test, merge_splices_nodes) {
+  // a small source goes node by node, a large one through the flat merge
+  for (int count : {10, 2000}) {
+    s21::set<int> s1;
+    std::set<int> s2;
+    for (int i = 0; i < 1000; i += 2) {
+      s1.insert(i);
+      s2.insert(i);
+    }
+    s21::set<int> s3;
+    std::set<int> s4;
+    for (int i = 0; i < count; i += 3) {
+      s3.insert(i);
+      s4.insert(i);
+    }
+    const int* moved{&*s3.find(3)};
+    const int* kept{&*s3.find(6)};
+    s1.merge(s3);
+    s2.merge(s4);
+    EXPECT_EQ(s1.size(), s2.size());
+    EXPECT_EQ(s3.size(), s4.size());
+    auto it1 = s1.begin();
+    for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+      EXPECT_EQ(*it1, *it2);
+    auto it3 = s3.begin();
+    for (auto it4 = s4.begin(); it4 != s4.end(); ++it3, ++it4)
+      EXPECT_EQ(*it3, *it4);
+    EXPECT_EQ(&*s1.find(3), moved);
+    EXPECT_EQ(&*s3.find(6), kept);
+    EXPECT_TRUE(s1.CheckBalance());
+    EXPECT_TRUE(s3.CheckBalance());
+  }
+}
+
+TEST(set_test, merge_into_empty_takes_nodes) {
+  s21::set<int> s1;
+  s21::set<int> s2 = {1, 2, 3};
+  const int* moved{&*s2.find(2)};
+  s1.merge(s2);
+  EXPECT_TRUE(s2.empty());
+  EXPECT_EQ(s1.size(), 3U);
+  EXPECT_EQ(&*s1.find(2), moved);
+}
+
+TEST(set_test, repeated_merge_keeps_memory) {
+  s21::set<int> s1;
+  for (int i = 0; i < 1000; ++i) s1.insert(i);
+  size_t capacity{0};
+  for (int round = 0; round < 2000; ++round) {
+    s21::set<int> batch;
+    for (int i = 0; i < 1000; i += 7) batch.insert(i);
+    batch.insert(1000 + round % 2);
+    s1.merge(batch);
+    s1.erase(s1.find(1000 + round % 2));
+    // the spliced node goes back to its batch, s1 allocates nothing
+    if (!round) capacity = s1.capacity();
+  }
+  EXPECT_EQ(s1.size(), 1000U);
+  EXPECT_EQ(s1.capacity(), capacity);
+  EXPECT_TRUE(s1.CheckBalance());
+}
+
+TEST(set_test, merged_nodes_return_to_source) {
+  s21::set<int> s1;
+  s21::set<int> staging;
+  for (int round = 0; round < 2000; ++round) {
+    for (int i = 0; i < 50; ++i) staging.insert(round * 50 + i);
+    if (round % 2) {
+      s1.merge(staging);
+      while (!s1.empty()) s1.erase(s1.begin());
+    } else {
+      s21::set<int> temporary{-1};
+      temporary.merge(staging);
+    }
+    EXPECT_TRUE(staging.empty());
+  }
+  // the freed slots come back to staging, whichever set freed them, so
+  // its first two slabs of 32 nodes do for all rounds
+  EXPECT_LE(staging.capacity(), 64U);
+  EXPECT_LE(s1.capacity(), 64U);
+}
+
+TEST(set_test, merged_sets_on_threads) {
+  s21::set<int> s1;
+  s21::set<int> s2;
+  for (int i = 0; i < 3000; ++i) (i % 3 ? s1 : s2).insert(i);
+  for (int i = 0; i < 3000; i += 6) s2.insert(i + 1);
+  s1.merge(s2);
+  ASSERT_EQ(s1.size(), 3000U);
+  ASSERT_EQ(s2.size(), 500U);
+  // each set now holds nodes of the other's slabs
+  std::thread worker([&s2] {
+    for (int round = 0; round < 20; ++round) {
+      for (int i = 0; i < 3000; i += 6) s2.erase(s2.find(i + 1));
+      for (int i = 0; i < 3000; i += 6) s2.insert(i + 1);
+    }
+  });
+  for (int round = 0; round < 20; ++round) {
+    for (int i = 0; i < 3000; i += 2) s1.erase(s1.find(i));
+    for (int i = 0; i < 3000; i += 2) s1.insert(i);
+  }
+  worker.join();
+  EXPECT_EQ(s1.size(), 3000U);
+  EXPECT_EQ(s2.size(), 500U);
+  EXPECT_TRUE(s1.CheckBalance());
+  EXPECT_TRUE(s2.CheckBalance());
+}
+
+TEST(set_test, merge_outlives_source) {
+  s21::set<std::string> s1 = {"b", "d"};
+  {
+    s21::set<std::string> s2 = {"a", "b", "c"};
+    s1.merge(s2);
+    s21::set<std::string> s3 = {"e"};
+    s2.merge(s3);
+    s1.merge(s2);
+  }
+  s1.insert("f");
+  s1.erase(s1.find("a"));
+  std::string joined;
+  for (const auto& value : s1) joined += value;
+  EXPECT_EQ(joined, "bcdef");
+}
+
+TEST(set_test, custom_compare) {
+  s21::set<int, std::greater<int>> s1 = {3, 1, 4, 1, 5};
+  std::set<int, std::greater<int>> s2 = {3, 1, 4, 1, 5};
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+  EXPECT_EQ(*s1.find(4), 4);
+  EXPECT_TRUE(s1.CheckBalance());
+}
+
+TEST(set_test, compare_once_per_level) {
+  struct counting_less {
+    int *calls;
+    bool operator()(int a, int b) const {
+      ++*calls;
+      return a < b;
+    }
+  };
+  int calls{0};
+  s21::set<int, counting_less> s1(counting_less{&calls});
+  for (int i = 0; i < 1023; ++i) s1.insert(i);
+  for (int i = 0; i < 1023; ++i) {
+    calls = 0;
+    EXPECT_TRUE(s1.contains(i));
+    // the height of a red-black tree is at most 2 * log2(n + 1)
+    EXPECT_LE(calls, 21);
+  }
+}
+
+TEST(set_test, transparent_lookup) {
+  s21::set<std::string, std::less<>> s1 = {"alpha", "beta", "gamma"};
+  EXPECT_EQ(*s1.find(std::string_view("beta")), "beta");
+  EXPECT_TRUE(s1.contains("gamma"));
+  EXPECT_FALSE(s1.contains(std::string_view("delta")));
+  EXPECT_EQ(s1.find("delta"), s1.end());
+}
+
+// a string_view does not convert to std::string implicitly, so these only
+// compile through the transparent overloads
+TEST(set_test, transparent_range_lookup) {
+  s21::ranked_multiset<std::string, std::less<>> s1 = {"alpha", "beta",
+                                                       "beta", "gamma"};
+  std::string_view beta{"beta"};
+  EXPECT_EQ(s1.count(beta), 2U);
+  auto range = s1.equal_range(beta);
+  EXPECT_EQ(range.first, s1.lower_bound(beta));
+  EXPECT_EQ(range.second, s1.upper_bound(beta));
+  EXPECT_EQ(*range.second, "gamma");
+  EXPECT_EQ(s1.rank(beta), 1U);
+  EXPECT_EQ(s1.count_range(beta, std::string_view("delta")), 2U);
+
+  s21::ranked_map<std::string, int, std::less<>> m1 = {{"one", 1},
+                                                       {"two", 2}};
+  std::string_view two{"two"};
+  EXPECT_EQ(m1.count(two), 1U);
+  EXPECT_EQ(m1.lower_bound(two)->second, 2);
+  EXPECT_EQ(m1.upper_bound(two), m1.end());
+  EXPECT_EQ(m1.equal_range(two).first, m1.lower_bound(two));
+  EXPECT_EQ(m1.rank(two), 1U);
+  EXPECT_EQ(m1.count_range(std::string_view("a"), two), 1U);
+}
+
 TEST(set_test, find1) {
   s21::set<int> s1 = {1, 2, 3, 4, 5, 6, 7, 8};
   std::set<int> s2 = {1, 2, 3, 4, 5, 6, 7, 8};
@@ -1384,6 +1920,73 @@ TEST(set_test, contains) {
   ASSERT_TRUE(s1.contains(3));
 }
 
+TEST(set_test, balance_sorted_insert) {
+  s21::set<int> s1;
+  std::set<int> s2;
+  for (int i = 0; i < 10000; ++i) {
+    s1.insert(i);
+    s2.insert(i);
+  }
+  EXPECT_TRUE(s1.CheckBalance());
+  EXPECT_EQ(s1.size(), s2.size());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+}
+
+TEST(set_test, balance_erase) {
+  s21::set<int> s1;
+  std::set<int> s2;
+  for (int i = 10000; i > 0; --i) {
+    s1.insert(i);
+    s2.insert(i);
+  }
+  for (int i = 1; i <= 10000; i += 3) {
+    s1.erase(s1.find(i));
+    s2.erase(i);
+    ASSERT_TRUE(s1.CheckBalance());
+  }
+  EXPECT_EQ(s1.size(), s2.size());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+}
+
+TEST(set_test, reserve) {
+  s21::set<int> s1;
+  s1.reserve(1000);
+  auto capacity = s1.capacity();
+  EXPECT_GE(capacity, 1000U);
+  for (int i = 0; i < 1000; ++i) s1.insert(i);
+  EXPECT_EQ(s1.capacity(), capacity);
+  EXPECT_TRUE(s1.CheckBalance());
+}
+
+TEST(set_test, node_reuse) {
+  s21::set<int> s1;
+  for (int i = 0; i < 500; ++i) s1.insert(i);
+  auto capacity = s1.capacity();
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 500; i += 2) s1.erase(s1.find(i));
+    for (int i = 0; i < 500; i += 2) s1.insert(i);
+  }
+  EXPECT_EQ(s1.capacity(), capacity);
+  EXPECT_EQ(s1.size(), 500U);
+  EXPECT_TRUE(s1.CheckBalance());
+}
+
+TEST(set_test, clear_large) {
+  s21::set<std::string> s1;
+  for (int i = 0; i < 100000; ++i) s1.insert(std::to_string(i));
+  s1.clear();
+  EXPECT_EQ(s1.size(), 0U);
+  EXPECT_TRUE(s1.empty());
+  EXPECT_EQ(s1.begin(), s1.end());
+  s1.insert("again");
+  EXPECT_EQ(*s1.begin(), "again");
+  EXPECT_TRUE(s1.CheckBalance());
+}
+
 //---------------------------------------------------------
 TEST(multiset_test, constr1) {
   s21::multiset<int> s1;
@@ -1406,6 +2009,8 @@ TEST(multiset_test, constr1_string) {
 TEST(multiset_test, constr2) {
   s21::multiset<int> s1 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 9, 10};
   std::multiset<int> s2 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 9, 10};
+  EXPECT_EQ(s1.size(), s2.size());
+  EXPECT_TRUE(s1.CheckBalance());
   auto it1 = s1.begin();
   for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
     EXPECT_EQ(*it1, *it2);
@@ -1498,6 +2103,93 @@ TEST(multiset_test, insert) {
     EXPECT_EQ(*it1, *it2);
 }
 
+TEST(multiset_test, insert_result) {
+  s21::multiset<int> s1 = {1, 3, 3, 5};
+  auto res = s1.insert(3);
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(*res.first, 3);
+  EXPECT_EQ(*++res.first, 5);
+  auto emplaced = s1.emplace(3);
+  EXPECT_EQ(*--emplaced.first, 3);
+  EXPECT_EQ(s1.size(), 6U);
+}
+
+TEST(multiset_test, insert_hint) {
+  s21::multiset<int> s1;
+  std::multiset<int> s2;
+  for (int i = 0; i < 1000; ++i) {
+    s1.insert(s1.end(), i / 3);
+    s2.insert(s2.end(), i / 3);
+  }
+  auto it = s1.insert(s1.find(100), 100);
+  EXPECT_EQ(it, s1.find(100));
+  EXPECT_EQ(*++it, 100);
+  s2.insert(100);
+  s1.emplace_hint(s1.begin(), 500);
+  s2.insert(500);
+  EXPECT_TRUE(s1.CheckBalance());
+  EXPECT_EQ(s1.size(), s2.size());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+}
+
+TEST(multiset_test, build_from_sorted) {
+  std::vector<int> keys = {1, 1, 2, 3, 3, 3, 7};
+  s21::multiset<int> s1(keys.begin(), keys.end());
+  EXPECT_EQ(s1.size(), keys.size());
+  EXPECT_TRUE(s1.CheckBalance());
+  EXPECT_TRUE(std::equal(keys.begin(), keys.end(), s1.begin()));
+  s1.build_from_sorted(keys.begin() + 2, keys.end());
+  EXPECT_EQ(s1.size(), 5U);
+  EXPECT_EQ(*s1.begin(), 2);
+}
+
+TEST(multiset_test, from_unsorted) {
+  std::vector<int> keys;
+  for (int i = 0; i < 80000; ++i) keys.push_back(i * 7919 % 1000);
+  s21::multiset<int> s1 =
+      s21::multiset<int>::from_unsorted(keys.begin(), keys.end(), 4);
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(s1.size(), keys.size());
+  EXPECT_TRUE(s1.CheckBalance());
+  EXPECT_TRUE(std::equal(keys.begin(), keys.end(), s1.begin()));
+}
+
+TEST(multiset_test, parallel_reduce) {
+  s21::multiset<int> s1;
+  for (int i = 0; i < 90000; ++i) s1.insert(i % 1000);
+  long long sum{s1.parallel_reduce(
+      0LL, [](long long total, int key) { return total + key; },
+      [](long long a, long long b) { return a + b; }, 4)};
+  EXPECT_EQ(sum, 90LL * 999 * 1000 / 2);
+}
+
+TEST(multiset_test, set_algebra) {
+  std::multiset<int> a = {1, 1, 1, 2, 4, 4, 7, 9, 9};
+  std::multiset<int> b = {1, 2, 2, 4, 4, 4, 8, 9};
+  std::vector<int> united, common, rest;
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                 std::back_inserter(united));
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(common));
+  std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                      std::back_inserter(rest));
+
+  s21::multiset<int> s1(a.begin(), a.end());
+  s21::multiset<int> s2(b.begin(), b.end());
+  s21::multiset<int> u{s21::set_union(s1, s2)};
+  s21::multiset<int> i{s21::set_intersection(s1, s2)};
+  s21::multiset<int> d{s21::set_difference(s1, s2)};
+  EXPECT_EQ(u.size(), united.size());
+  EXPECT_EQ(i.size(), common.size());
+  EXPECT_EQ(d.size(), rest.size());
+  EXPECT_TRUE(std::equal(united.begin(), united.end(), u.begin()));
+  EXPECT_TRUE(std::equal(common.begin(), common.end(), i.begin()));
+  EXPECT_TRUE(std::equal(rest.begin(), rest.end(), d.begin()));
+  EXPECT_TRUE(u.CheckBalance() && i.CheckBalance() && d.CheckBalance());
+}
+
 TEST(multiset_test, swap) {
   s21::multiset<int> s1 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 9};
   std::multiset<int> s2 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 9};
@@ -1575,6 +2267,70 @@ TEST(multiset_test, merge_duplicate) {
     EXPECT_EQ(*it3, *it4);
 }
 
+TEST(multiset_test, merge_keeps_equal_order) {
+  // ordered by the first member only, the second tells the sources apart
+  struct first_less {
+    bool operator()(const std::pair<int, int>& a,
+                    const std::pair<int, int>& b) const {
+      return a.first < b.first;
+    }
+  };
+  for (int count : {2, 500}) {
+    s21::multiset<std::pair<int, int>, first_less> s1 = {
+        {1, 1}, {5, 1}, {9, 1}};
+    s21::multiset<std::pair<int, int>, first_less> s2;
+    for (int i = 0; i < count; ++i) s2.insert({i % 10, 2});
+    const std::pair<int, int>* first{&*s1.find({5, 0})};
+    const std::pair<int, int>* second{&*s2.find({5 % count, 0})};
+    s1.merge(s2);
+    EXPECT_TRUE(s2.empty());
+    EXPECT_EQ(s1.size(), static_cast<size_t>(count) + 3);
+    EXPECT_TRUE(s1.CheckBalance());
+    if (count > 5) {
+      auto it = s1.find({5, 0});
+      EXPECT_EQ(&*it, first);
+      EXPECT_EQ(&*++it, second);
+      EXPECT_EQ(it->second, 2);
+    }
+  }
+}
+
+TEST(multiset_test, order_statistics) {
+  s21::ranked_multiset<int> s1;
+  std::multiset<int> s2;
+  unsigned seed{7};
+  for (int i = 0; i < 3000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int value = static_cast<int>(seed >> 16) % 500;
+    if (i % 3 == 2 && s1.contains(value)) {
+      s1.erase(s1.find(value));
+      s2.erase(s2.find(value));
+    } else {
+      s1.insert(value);
+      s2.insert(value);
+    }
+  }
+  s21::ranked_multiset<int> s3 = {1, 250, 250, 600};
+  std::multiset<int> s4 = {1, 250, 250, 600};
+  s1.merge(s3);
+  s2.merge(s4);
+  s21::ranked_multiset<int> s5(s1);
+  EXPECT_TRUE(s5.CheckBalance());
+
+  ASSERT_EQ(s5.size(), s2.size());
+  size_t index{0};
+  for (auto it = s2.begin(); it != s2.end(); ++it, ++index)
+    EXPECT_EQ(*s5.nth(index), *it);
+  EXPECT_EQ(s5.nth(s2.size()), s5.end());
+  for (int key = -1; key <= 601; key += 50) {
+    auto below = std::distance(s2.begin(), s2.lower_bound(key));
+    EXPECT_EQ(s5.rank(key), static_cast<size_t>(below));
+  }
+  auto in_range = std::distance(s2.lower_bound(100), s2.lower_bound(200));
+  EXPECT_EQ(s5.count_range(100, 200), static_cast<size_t>(in_range));
+  EXPECT_EQ(s5.count_range(200, 100), 0U);
+}
+
 TEST(multiset_test, find1) {
   s21::multiset<int> s1 = {1, 2, 3, 4, 5, 6, 7, 8};
   std::multiset<int> s2 = {1, 2, 3, 4, 5, 6, 7, 8};
@@ -1595,6 +2351,24 @@ TEST(multiset_test, contains) {
   ASSERT_TRUE(s1.contains(3));
 }
 
+TEST(multiset_test, balance_duplicates) {
+  s21::multiset<int> s1;
+  std::multiset<int> s2;
+  for (int i = 0; i < 5000; ++i) {
+    s1.insert(i / 4);
+    s2.insert(i / 4);
+  }
+  EXPECT_TRUE(s1.CheckBalance());
+  while (s1.size() > 2000) {
+    s1.erase(s1.begin());
+    s2.erase(s2.begin());
+  }
+  EXPECT_TRUE(s1.CheckBalance());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+}
+
 TEST(multiset_test, count) {
   s21::multiset<int> s1 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 6};
   std::multiset<int> s2 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 6};
@@ -1634,10 +2408,10 @@ TEST(multiset_test, equal_range_no_greater_then_key) {
 TEST(multiset_test, equal_range_no_less_then_key) {
   s21::multiset<int> s1 = {1, 2, 3, 4, 5, 6, 6, 6};
   auto range_first1 = s1.equal_range(0).first;
-  auto range_first2 = s1.end();
+  auto range_first2 = s1.begin();
   EXPECT_EQ(range_first1, range_first2);
   auto range_second1 = s1.equal_range(0).second;
-  auto range_second2 = s1.end();
+  auto range_second2 = s1.begin();
   EXPECT_EQ(range_second1, range_second2);
 }
 
@@ -1650,7 +2424,7 @@ TEST(multiset_test, lower_bound) {
 
 TEST(multiset_test, lower_bound_no_less) {
   s21::multiset<int> s1 = {1, 2, 3, 4, 5, 6, 6, 7, 8, 6};
-  auto range_first1 = s1.end();
+  auto range_first1 = s1.begin();
   auto range_first2 = s1.lower_bound(0);
   EXPECT_EQ(range_first1, range_first2);
 }
@@ -1669,6 +2443,1032 @@ TEST(multiset_test, upper_bound_no_greater) {
   EXPECT_EQ(range_second1, range_second2);
 }
 
+TEST(multiset_test, bounds_match_std) {
+  s21::multiset<int> s1;
+  std::multiset<int> s2;
+  for (int i = 0; i < 200; ++i) {
+    s1.insert(i * 7 % 50 * 2);
+    s2.insert(i * 7 % 50 * 2);
+  }
+  for (int key = -1; key <= 101; ++key) {
+    auto lower = std::distance(s2.begin(), s2.lower_bound(key));
+    auto upper = std::distance(s2.begin(), s2.upper_bound(key));
+    auto it = s1.begin();
+    for (auto i = 0; i < lower; ++i) ++it;
+    EXPECT_EQ(s1.lower_bound(key), it);
+    for (auto i = lower; i < upper; ++i) ++it;
+    EXPECT_EQ(s1.upper_bound(key), it);
+    EXPECT_EQ(s1.count(key), s2.count(key));
+  }
+}
+
+TEST(set_test, bounds) {
+  s21::set<int> s1 = {10, 20, 30};
+  EXPECT_EQ(*s1.lower_bound(15), 20);
+  EXPECT_EQ(*s1.lower_bound(20), 20);
+  EXPECT_EQ(*s1.upper_bound(20), 30);
+  EXPECT_EQ(s1.upper_bound(30), s1.end());
+  EXPECT_EQ(s1.lower_bound(5), s1.begin());
+  auto range = s1.equal_range(25);
+  EXPECT_EQ(range.first, range.second);
+  EXPECT_EQ(*range.first, 30);
+  EXPECT_EQ(s1.count(20), 1U);
+  EXPECT_EQ(s1.count(25), 0U);
+}
+
+TEST(counted_multiset_test, iterates_every_copy) {
+  s21::counted_multiset<int> s1 = {5, 1, 5, 3, 5, 1};
+  std::multiset<int> s2 = {5, 1, 5, 3, 5, 1};
+  EXPECT_EQ(s1.size(), s2.size());
+  EXPECT_EQ(s1.distinct_size(), 3U);
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+  EXPECT_EQ(it1, s1.end());
+  auto it3 = s1.end();
+  for (auto it4 = s2.end(); it4 != s2.begin();) EXPECT_EQ(*--it3, *--it4);
+  EXPECT_EQ(it3, s1.begin());
+}
+
+TEST(counted_multiset_test, count_and_bounds) {
+  s21::counted_multiset<int> s1;
+  for (int i = 0; i < 10000; ++i) s1.insert(i % 7);
+  EXPECT_EQ(s1.size(), 10000U);
+  EXPECT_EQ(s1.distinct_size(), 7U);
+  EXPECT_EQ(s1.count(3), 1429U);
+  EXPECT_EQ(s1.count(7), 0U);
+  auto range = s1.equal_range(6);
+  size_t copies{0};
+  for (auto it = range.first; it != range.second; ++it, ++copies)
+    EXPECT_EQ(*it, 6);
+  EXPECT_EQ(copies, s1.count(6));
+  EXPECT_EQ(range.second, s1.end());
+  EXPECT_EQ(*s1.lower_bound(-1), 0);
+  EXPECT_TRUE(s1.CheckBalance());
+}
+
+TEST(counted_multiset_test, const_lookup) {
+  const s21::counted_multiset<int> s1 = {1, 3, 3, 5};
+  EXPECT_EQ(s1.count(3), 2U);
+  EXPECT_TRUE(s1.contains(5));
+  EXPECT_FALSE(s1.contains(4));
+  EXPECT_EQ(*s1.find(1), 1);
+  EXPECT_EQ(*s1.lower_bound(2), 3);
+  EXPECT_EQ(*s1.upper_bound(3), 5);
+  auto range = s1.equal_range(3);
+  EXPECT_EQ(range.first, s1.find(3));
+  EXPECT_EQ(range.second, s1.find(5));
+  int sum{0};
+  for (auto it = s1.begin(); it != s1.end(); ++it) sum += *it;
+  EXPECT_EQ(sum, 12);
+}
+
+TEST(counted_multiset_test, erase_one_copy) {
+  s21::counted_multiset<std::string> s1 = {"a", "b", "b", "b"};
+  const std::string *key{&*s1.find("b")};
+  s1.erase(s1.find("b"));
+  EXPECT_EQ(s1.count("b"), 2U);
+  EXPECT_EQ(&*s1.find("b"), key);
+  EXPECT_EQ(s1.distinct_size(), 2U);
+  s1.erase(s1.find("a"));
+  EXPECT_FALSE(s1.contains("a"));
+  EXPECT_EQ(s1.size(), 2U);
+  EXPECT_EQ(s1.distinct_size(), 1U);
+}
+
+TEST(counted_multiset_test, copy_move_merge) {
+  s21::counted_multiset<int> s1 = {1, 2, 2};
+  s21::counted_multiset<int> s2(s1);
+  s21::counted_multiset<int> s3 = {2, 3};
+  s2.merge(s3);
+  EXPECT_TRUE(s3.empty());
+  EXPECT_EQ(s2.size(), 5U);
+  EXPECT_EQ(s2.count(2), 3U);
+  EXPECT_EQ(s1.count(2), 2U);
+  s21::counted_multiset<int> s4(std::move(s2));
+  EXPECT_EQ(s4.size(), 5U);
+  EXPECT_TRUE(s2.empty());
+  s1 = s4;
+  EXPECT_EQ(s1.count(3), 1U);
+}
+
+TEST(btree_test, random_against_std) {
+  s21::btree_multiset<int, std::less<int>, 4> s1;
+  std::multiset<int> s2;
+  unsigned seed{11};
+  for (int i = 0; i < 20000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int value = static_cast<int>(seed >> 16) % 700;
+    if (i % 5 >= 3 && s1.contains(value)) {
+      s1.erase(s1.find(value));
+      s2.erase(s2.find(value));
+    } else {
+      EXPECT_EQ(*s1.insert(value).first, value);
+      s2.insert(value);
+    }
+    if (i % 1000 == 0) {
+      EXPECT_TRUE(s1.CheckBalance());
+    }
+  }
+  EXPECT_TRUE(s1.CheckBalance());
+  ASSERT_EQ(s1.size(), s2.size());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+  EXPECT_EQ(it1, s1.end());
+  for (auto it2 = s2.end(); it2 != s2.begin();) EXPECT_EQ(*--it1, *--it2);
+  for (int key = -1; key <= 701; key += 7) {
+    EXPECT_EQ(s1.count(key), s2.count(key));
+    auto lower = s2.lower_bound(key);
+    if (lower == s2.end()) {
+      EXPECT_EQ(s1.lower_bound(key), s1.end());
+    } else {
+      EXPECT_EQ(*s1.lower_bound(key), *lower);
+    }
+  }
+
+  while (!s1.empty()) s1.erase(s1.begin());
+  EXPECT_TRUE(s1.CheckBalance());
+  EXPECT_EQ(s1.begin(), s1.end());
+}
+
+TEST(btree_test, set_unique_and_copy) {
+  s21::btree_set<std::string, std::less<std::string>, 6> s1;
+  std::set<std::string> s2;
+  for (int i = 0; i < 500; ++i) {
+    std::string key{"key-" + std::to_string(i * 37 % 211)};
+    EXPECT_EQ(s1.insert(key).second, s2.insert(key).second);
+  }
+  s21::btree_set<std::string, std::less<std::string>, 6> s3(s1);
+  s3.erase(s3.find("key-7"));
+  EXPECT_TRUE(s1.contains("key-7"));
+  EXPECT_FALSE(s3.contains("key-7"));
+  EXPECT_TRUE(s3.CheckBalance());
+  EXPECT_EQ(s1.size(), s2.size());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+
+  s21::btree_set<std::string, std::less<std::string>, 6> s4 = {"key-7", "z"};
+  s3.merge(s4);
+  EXPECT_EQ(s3.size(), s2.size() + 1);
+  EXPECT_TRUE(s4.empty());
+  s1 = std::move(s3);
+  EXPECT_TRUE(s1.contains("z"));
+}
+
+TEST(btree_test, set_reinsert_into_full_nodes) {
+  // the root is full, re-inserting the last key splits it first
+  s21::btree_set<int> s1;
+  for (int i = 0; i < 63; ++i) s1.insert(i);
+  EXPECT_FALSE(s1.insert(62).second);
+  EXPECT_TRUE(s1.CheckBalance());
+  EXPECT_EQ(*--s1.end(), 62);
+  EXPECT_EQ(*s1.begin(), 0);
+
+  // with three keys a node, every few inserts leave the last leaf full
+  s21::btree_set<int, std::less<int>, 4> s2;
+  for (int i = 0; i < 200; ++i) {
+    s2.insert(i);
+    EXPECT_FALSE(s2.insert(i).second);
+    EXPECT_FALSE(s2.insert(i / 2).second);
+    ASSERT_TRUE(s2.CheckBalance());
+    EXPECT_EQ(*--s2.end(), i);
+    EXPECT_EQ(*s2.begin(), 0);
+  }
+  int count{0};
+  for (auto it = s2.begin(); it != s2.end(); ++it) EXPECT_EQ(*it, count++);
+  EXPECT_EQ(count, 200);
+}
+
+TEST(btree_test, insert_many_iterators) {
+  // later values shift the earlier ones inside a leaf and split it
+  s21::btree_set<int, std::less<int>, 4> s1;
+  auto r1 = s1.insert_many(3, 1, 2, 9, 8, 7, 6, 5, 4, 0, 2);
+  std::vector<int> expected{3, 1, 2, 9, 8, 7, 6, 5, 4, 0, 2};
+  for (size_t i = 0; i < expected.size(); ++i)
+    EXPECT_EQ(*r1[i].first, expected[i]);
+  EXPECT_FALSE(r1.back().second);
+
+  // ordered by the first member only, the second tells the copies apart
+  struct first_less {
+    bool operator()(const std::pair<int, int>& a,
+                    const std::pair<int, int>& b) const {
+      return a.first < b.first;
+    }
+  };
+  s21::btree_multiset<std::pair<int, int>, first_less, 4> s2;
+  auto r2 = s2.insert_many(std::make_pair(3, 0), std::make_pair(1, 1),
+                           std::make_pair(3, 2), std::make_pair(2, 3),
+                           std::make_pair(3, 4), std::make_pair(0, 5),
+                           std::make_pair(3, 6), std::make_pair(1, 7));
+  for (int i = 0; i < 8; ++i) EXPECT_EQ(r2[i].first->second, i);
+
+  s21::btree_map<int, int> m1;
+  auto r3 = m1.insert_many(std::make_pair(3, 30), std::make_pair(1, 10),
+                           std::make_pair(3, 0));
+  EXPECT_EQ(r3[0].first->first, 3);
+  EXPECT_EQ(r3[1].first->first, 1);
+  EXPECT_EQ(r3[2].first->second, 30);
+  EXPECT_FALSE(r3[2].second);
+}
+
+TEST(btree_test, map_interface) {
+  s21::btree_map<int, std::string> test = {{2, "b"}, {1, "a"}};
+  std::map<int, std::string> origin = {{2, "b"}, {1, "a"}};
+  for (int i = 0; i < 2000; ++i) {
+    test[i * 3 % 1000] += "x";
+    origin[i * 3 % 1000] += "x";
+  }
+  EXPECT_FALSE(test.insert(1, "q").second);
+  test.insert_or_assign(1, "q");
+  origin[1] = "q";
+  EXPECT_EQ(test.at(1), "q");
+  EXPECT_THROW(test.at(1000), std::invalid_argument);
+  EXPECT_TRUE(test.CheckBalance());
+  ASSERT_EQ(test.size(), origin.size());
+  auto j = origin.begin();
+  for (auto i = test.begin(); i != test.end(); ++i, ++j) {
+    EXPECT_EQ(i->first, j->first);
+    EXPECT_EQ(i->second, j->second);
+  }
+  EXPECT_EQ(test.upper_bound(998)->first, 999);
+}
+
+// a string_view does not convert to std::string implicitly, so these only
+// compile through the transparent overloads
+TEST(btree_test, transparent_lookup) {
+  s21::btree_multiset<std::string, std::less<>> s1 = {"alpha", "beta", "beta",
+                                                      "gamma"};
+  std::string_view beta{"beta"};
+  EXPECT_EQ(*s1.find(beta), "beta");
+  EXPECT_TRUE(s1.contains(beta));
+  EXPECT_FALSE(s1.contains(std::string_view("delta")));
+  EXPECT_EQ(s1.count(beta), 2U);
+  auto range = s1.equal_range(beta);
+  EXPECT_EQ(range.first, s1.lower_bound(beta));
+  EXPECT_EQ(range.second, s1.upper_bound(beta));
+  EXPECT_EQ(*range.second, "gamma");
+
+  s21::btree_map<std::string, int, std::less<>> m1 = {{"one", 1},
+                                                      {"two", 2}};
+  std::string_view two{"two"};
+  EXPECT_EQ(m1.at(two), 2);
+  EXPECT_THROW(m1.at(std::string_view("three")), std::invalid_argument);
+  EXPECT_TRUE(m1.contains(two));
+  EXPECT_EQ(m1.find(two)->second, 2);
+  EXPECT_EQ(m1.count(two), 1U);
+  EXPECT_EQ(m1.lower_bound(two)->second, 2);
+  EXPECT_EQ(m1.upper_bound(two), m1.end());
+  EXPECT_EQ(m1.equal_range(two).first, m1.lower_bound(two));
+}
+
+TEST(flat_test, random_against_std) {
+  s21::flat_multiset<int> s1;
+  std::multiset<int> s2;
+  unsigned seed{17};
+  for (int i = 0; i < 5000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int value = static_cast<int>(seed >> 16) % 300;
+    if (i % 5 >= 3 && s1.contains(value)) {
+      s1.erase(s1.find(value));
+      s2.erase(s2.find(value));
+    } else {
+      EXPECT_EQ(*s1.insert(value).first, value);
+      s2.insert(value);
+    }
+  }
+  EXPECT_TRUE(s1.CheckBalance());
+  ASSERT_EQ(s1.size(), s2.size());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+  for (int key = -1; key <= 301; key += 7) {
+    EXPECT_EQ(s1.count(key), s2.count(key));
+    auto upper = s2.upper_bound(key);
+    if (upper == s2.end()) {
+      EXPECT_EQ(s1.upper_bound(key), s1.end());
+    } else {
+      EXPECT_EQ(*s1.upper_bound(key), *upper);
+    }
+  }
+}
+
+TEST(flat_test, insert_range) {
+  s21::flat_set<int> s1 = {50, 10, 30};
+  std::set<int> s2 = {50, 10, 30};
+  std::vector<int> batch;
+  for (int i = 0; i < 1000; ++i) batch.push_back(i * 7 % 101);
+  s1.insert_range(batch.begin(), batch.end());
+  s2.insert(batch.begin(), batch.end());
+  EXPECT_TRUE(s1.CheckBalance());
+  ASSERT_EQ(s1.size(), s2.size());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+
+  s21::flat_multiset<int> s3 = {5, 1};
+  s3.insert_range(batch.begin(), batch.end());
+  EXPECT_EQ(s3.size(), batch.size() + 2);
+  EXPECT_EQ(s3.count(5), 11U);
+  EXPECT_TRUE(s3.CheckBalance());
+
+  s21::flat_set<int> s4;
+  s4.insert(s4.end(), 3);
+  s4.insert(s4.end(), 1);
+  s4.insert(s4.begin(), 2);
+  EXPECT_FALSE(s4.insert(2).second);
+  EXPECT_EQ(*s4.begin(), 1);
+  EXPECT_EQ(*(s4.end() - 1), 3);
+  EXPECT_TRUE(s4.CheckBalance());
+
+  std::vector<int> unsorted{1, 3, 2};
+  EXPECT_THROW(s4.build_from_sorted(unsorted.begin(), unsorted.end()),
+               std::invalid_argument);
+  EXPECT_EQ(s4.size(), 3U);
+}
+
+TEST(flat_test, set_merge_and_copy) {
+  s21::flat_set<std::string> s1 = {"a", "c", "e"};
+  s21::flat_set<std::string> s2 = {"b", "c", "d"};
+  s1.merge(s2);
+  EXPECT_EQ(s1.size(), 5U);
+  EXPECT_EQ(s2.size(), 1U);
+  EXPECT_TRUE(s2.contains("c"));
+  std::string joined;
+  for (const std::string& key : s1) joined += key;
+  EXPECT_EQ(joined, "abcde");
+
+  s21::flat_set<std::string> s3(s1);
+  s3.erase(s3.find("a"));
+  EXPECT_TRUE(s1.contains("a"));
+  EXPECT_FALSE(s3.contains("a"));
+  s1 = std::move(s3);
+  EXPECT_EQ(s1.size(), 4U);
+  s1.shrink_to_fit();
+  s1.clear();
+  s1.insert("z");
+  EXPECT_EQ(*s1.begin(), "z");
+}
+
+// counts the copies so a test can tell them from moves
+struct copy_counted {
+  static int copies;
+  int key{0};
+  copy_counted() = default;
+  explicit copy_counted(int k) : key{k} {}
+  copy_counted(const copy_counted& other) : key{other.key} { ++copies; }
+  copy_counted(copy_counted&&) = default;
+  copy_counted& operator=(const copy_counted& other) {
+    key = other.key;
+    ++copies;
+    return *this;
+  }
+  copy_counted& operator=(copy_counted&&) = default;
+  bool operator<(const copy_counted& other) const { return key < other.key; }
+};
+int copy_counted::copies{0};
+
+TEST(flat_test, merge_moves_values) {
+  s21::flat_set<copy_counted> s1;
+  auto result = s1.insert(copy_counted(2));
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(result.first, s1.begin());
+  result = s1.insert(copy_counted(2));
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(result.first, s1.begin());
+  s1.insert(copy_counted(4));
+
+  s21::flat_set<copy_counted> s2;
+  for (int key : {1, 2, 3}) s2.insert(copy_counted(key));
+  copy_counted::copies = 0;
+  s1.merge(s2);
+  EXPECT_EQ(copy_counted::copies, 0);
+  ASSERT_EQ(s1.size(), 4U);
+  ASSERT_EQ(s2.size(), 1U);
+  EXPECT_EQ(s2.begin()->key, 2);
+  int expected{1};
+  for (const copy_counted& value : s1) EXPECT_EQ(value.key, expected++);
+}
+
+TEST(flat_test, merge_small) {
+  s21::flat_set<int> empty;
+  s21::flat_set<int> one = {1};
+  EXPECT_NO_THROW(empty.merge(one));
+  EXPECT_EQ(empty.size(), 1U);
+  EXPECT_TRUE(one.empty());
+
+  s21::flat_set<int> five = {5};
+  one.insert(1);
+  EXPECT_NO_THROW(five.merge(one));
+  ASSERT_EQ(five.size(), 2U);
+  EXPECT_EQ(*five.begin(), 1);
+  EXPECT_TRUE(one.empty());
+
+  s21::flat_map<int, std::string> map = {{2, "b"}};
+  s21::flat_map<int, std::string> other = {{1, "a"}};
+  EXPECT_NO_THROW(map.merge(other));
+  ASSERT_EQ(map.size(), 2U);
+  EXPECT_EQ(map.at(1), "a");
+  EXPECT_TRUE(other.empty());
+}
+
+TEST(flat_test, emplace_moves_values) {
+  s21::flat_set<copy_counted> s1;
+  copy_counted::copies = 0;
+  for (int key : {3, 1, 2}) s1.emplace(key);
+  EXPECT_FALSE(s1.emplace(2).second);
+  EXPECT_EQ(copy_counted::copies, 0);
+  int expected{1};
+  for (const copy_counted& value : s1) EXPECT_EQ(value.key, expected++);
+
+  s21::flat_map<int, std::unique_ptr<int>> m1;
+  for (int key : {5, 1, 3, 2, 4}) m1.emplace(key, std::make_unique<int>(key));
+  EXPECT_FALSE(m1.emplace(3, std::make_unique<int>(0)).second);
+  ASSERT_EQ(m1.size(), 5U);
+  for (int key = 1; key <= 5; ++key) EXPECT_EQ(*m1.find(key)->second, key);
+}
+
+TEST(flat_test, map_interface) {
+  s21::flat_map<int, std::string> test = {{2, "b"}, {1, "a"}, {2, "c"}};
+  std::map<int, std::string> origin = {{2, "b"}, {1, "a"}};
+  EXPECT_EQ(test.at(2), "b");
+  for (int i = 0; i < 2000; ++i) {
+    test[i * 3 % 1000] += "x";
+    origin[i * 3 % 1000] += "x";
+  }
+  EXPECT_FALSE(test.insert(1, "q").second);
+  test.insert_or_assign(1, "q");
+  origin[1] = "q";
+  std::vector<std::pair<int, std::string>> batch = {{5000, "n"}, {1, "no"}};
+  test.insert_range(batch.begin(), batch.end());
+  origin.insert(batch.begin(), batch.end());
+  EXPECT_EQ(test.at(1), "q");
+  EXPECT_THROW(test.at(1000), std::invalid_argument);
+  EXPECT_TRUE(test.CheckBalance());
+  ASSERT_EQ(test.size(), origin.size());
+  auto j = origin.begin();
+  for (auto i = test.begin(); i != test.end(); ++i, ++j) {
+    EXPECT_EQ(i->first, j->first);
+    EXPECT_EQ(i->second, j->second);
+  }
+  EXPECT_EQ(test.upper_bound(998)->first, 999);
+}
+
+// read-mostly sets are queried through const references
+TEST(flat_test, const_lookup) {
+  const s21::flat_set<int> s1 = {1, 3, 5};
+  EXPECT_TRUE(s1.contains(3));
+  EXPECT_FALSE(s1.contains(4));
+  EXPECT_EQ(*s1.find(5), 5);
+  const s21::flat_multiset<int> s2 = {2, 2, 4};
+  EXPECT_TRUE(s2.contains(2));
+  EXPECT_EQ(*s2.find(4), 4);
+  EXPECT_EQ(s2.count(2), 2U);
+}
+
+// a string_view does not convert to std::string implicitly, so these only
+// compile through the transparent overloads
+TEST(flat_test, transparent_lookup) {
+  s21::flat_multiset<std::string, std::less<>> s1 = {"alpha", "beta", "beta",
+                                                     "gamma"};
+  std::string_view beta{"beta"};
+  EXPECT_EQ(*s1.find(beta), "beta");
+  EXPECT_TRUE(s1.contains(beta));
+  EXPECT_FALSE(s1.contains(std::string_view("delta")));
+  EXPECT_EQ(s1.count(beta), 2U);
+  auto range = s1.equal_range(beta);
+  EXPECT_EQ(range.first, s1.lower_bound(beta));
+  EXPECT_EQ(range.second, s1.upper_bound(beta));
+  EXPECT_EQ(*range.second, "gamma");
+
+  s21::flat_map<std::string, int, std::less<>> m1 = {{"one", 1}, {"two", 2}};
+  std::string_view two{"two"};
+  EXPECT_EQ(m1.at(two), 2);
+  EXPECT_THROW(m1.at(std::string_view("three")), std::invalid_argument);
+  EXPECT_TRUE(m1.contains(two));
+  EXPECT_EQ(m1.find(two)->second, 2);
+  EXPECT_EQ(m1.count(two), 1U);
+  EXPECT_EQ(m1.lower_bound(two)->second, 2);
+  EXPECT_EQ(m1.upper_bound(two), m1.end());
+  EXPECT_EQ(m1.equal_range(two).first, m1.lower_bound(two));
+}
+
+TEST(flat_test, insert_many_iterators) {
+  // descending values shift all earlier ones and outgrow the first block
+  s21::flat_set<int> s1;
+  auto r1 = s1.insert_many(5, 4, 3, 2, 1, 0, 4);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(*r1[i].first, 5 - i);
+    EXPECT_TRUE(r1[i].second);
+  }
+  EXPECT_EQ(*r1[6].first, 4);
+  EXPECT_FALSE(r1[6].second);
+
+  // ordered by the first member only, the second tells the copies apart
+  struct first_less {
+    bool operator()(const std::pair<int, int>& a,
+                    const std::pair<int, int>& b) const {
+      return a.first < b.first;
+    }
+  };
+  s21::flat_multiset<std::pair<int, int>, first_less> s2;
+  auto r2 = s2.insert_many(std::make_pair(3, 0), std::make_pair(1, 1),
+                           std::make_pair(3, 2), std::make_pair(2, 3),
+                           std::make_pair(3, 4), std::make_pair(0, 5));
+  for (int i = 0; i < 6; ++i) EXPECT_EQ(r2[i].first->second, i);
+
+  s21::flat_map<int, std::string> m1;
+  using entry = std::pair<int, std::string>;
+  auto r3 = m1.insert_many(entry{3, "c"}, entry{1, "a"}, entry{2, "b"},
+                           entry{1, "x"}, entry{0, "z"});
+  EXPECT_EQ(r3[0].first->second, "c");
+  EXPECT_EQ(r3[1].first->second, "a");
+  EXPECT_EQ(r3[2].first->second, "b");
+  EXPECT_EQ(r3[3].first->second, "a");
+  EXPECT_FALSE(r3[3].second);
+  EXPECT_EQ(r3[4].first->first, 0);
+}
+
+TEST(frozen_test, set_against_tree) {
+  for (int n : {0, 1, 2, 3, 7, 8, 100, 1000}) {
+    s21::set<int> origin;
+    for (int i = 0; i < n; ++i) origin.insert(i * 2);
+    s21::frozen_set<int> frozen{origin.freeze()};
+    ASSERT_EQ(frozen.size(), origin.size());
+    auto it = frozen.begin();
+    for (int value : origin) EXPECT_EQ(*it++, value);
+    EXPECT_EQ(it, frozen.end());
+    for (auto back = origin.end(); back != origin.begin();)
+      EXPECT_EQ(*--it, *--back);
+    EXPECT_EQ(it, frozen.begin());
+    for (int key = -1; key <= 2 * n; ++key) {
+      EXPECT_EQ(frozen.contains(key), origin.contains(key));
+      auto lower = frozen.lower_bound(key);
+      if (origin.lower_bound(key) == origin.end()) {
+        EXPECT_EQ(lower, frozen.end());
+      } else {
+        EXPECT_EQ(*lower, *origin.lower_bound(key));
+      }
+      auto upper = frozen.upper_bound(key);
+      if (origin.upper_bound(key) == origin.end()) {
+        EXPECT_EQ(upper, frozen.end());
+      } else {
+        EXPECT_EQ(*upper, *origin.upper_bound(key));
+      }
+    }
+  }
+}
+
+TEST(frozen_test, multiset_and_map) {
+  s21::multiset<int> origin = {5, 1, 5, 3, 5, 1};
+  s21::frozen_set<int> frozen{origin.freeze()};
+  origin.clear();
+  EXPECT_EQ(frozen.size(), 6U);
+  EXPECT_EQ(frozen.count(5), 3U);
+  EXPECT_EQ(frozen.count(1), 2U);
+  EXPECT_EQ(frozen.count(2), 0U);
+  EXPECT_EQ(frozen.find(2), frozen.end());
+
+  s21::map<std::string, int> words = {{"b", 2}, {"a", 1}, {"c", 3}};
+  s21::frozen_map<std::string, int> snapshot{words.freeze()};
+  words["a"] = 10;
+  EXPECT_EQ(snapshot.at("a"), 1);
+  EXPECT_EQ(snapshot.find("c")->second, 3);
+  EXPECT_THROW(snapshot.at("d"), std::invalid_argument);
+  s21::frozen_map<std::string, int> copy;
+  copy = snapshot;
+  snapshot = words.freeze();
+  EXPECT_EQ(snapshot.at("a"), 10);
+  EXPECT_EQ(copy.at("a"), 1);
+  EXPECT_EQ(copy.begin()->first, "a");
+}
+
+TEST(frozen_test, moved_from_is_empty) {
+  s21::set<int> origin = {1, 2, 3};
+  s21::frozen_set<int> frozen{origin.freeze()};
+  s21::frozen_set<int> taken{std::move(frozen)};
+  EXPECT_EQ(taken.size(), 3U);
+  EXPECT_TRUE(frozen.empty());
+  EXPECT_EQ(frozen.begin(), frozen.end());
+  EXPECT_FALSE(frozen.contains(2));
+  s21::frozen_set<int> copy{frozen};
+  EXPECT_TRUE(copy.empty());
+  frozen = std::move(taken);
+  EXPECT_TRUE(frozen.contains(2));
+  EXPECT_TRUE(taken.empty());
+}
+
+template <class T>
+void CheckSimdSearch(std::vector<T> keys, std::vector<T> probes) {
+  std::sort(keys.begin(), keys.end());
+  for (size_t count = 0; count <= keys.size(); ++count) {
+    for (T probe : probes) {
+      size_t lower = std::lower_bound(keys.begin(), keys.begin() + count,
+                                      probe) -
+                     keys.begin();
+      size_t upper = std::upper_bound(keys.begin(), keys.begin() + count,
+                                      probe) -
+                     keys.begin();
+      EXPECT_EQ(s21::SimdLowerIndex(keys.data(), count, probe), lower);
+      EXPECT_EQ(s21::SimdUpperIndex(keys.data(), count, probe), upper);
+    }
+  }
+}
+
+TEST(simd_search_test, kernels_against_std) {
+  std::vector<int> ints{-7, -7, 0, 1, 1, 1, 5, 9, 12, 12, 40, 41, 100,
+                        std::numeric_limits<int>::max(),
+                        std::numeric_limits<int>::min()};
+  CheckSimdSearch(ints, {std::numeric_limits<int>::min(), -8, -7, 1, 2, 12,
+                         100, std::numeric_limits<int>::max()});
+  std::vector<uint32_t> small{0, 1, 2, 2, 7, 0x7fffffffU, 0x80000000U,
+                              0x80000001U, 0xfffffffeU, 0xffffffffU};
+  CheckSimdSearch(small, {0U, 2U, 3U, 0x80000000U, 0xffffffffU});
+  std::vector<uint64_t> large{0, 5, 5, 1ULL << 63, (1ULL << 63) + 1,
+                              ~0ULL, 17, 1ULL << 40};
+  CheckSimdSearch(large, {0ULL, 5ULL, 6ULL, 1ULL << 63, ~0ULL});
+  std::vector<float> floats{-1.5f, 0.0f, 0.25f, 0.25f, 3.0f, 1e30f, -1e30f};
+  CheckSimdSearch(floats, {-2.0f, 0.0f, 0.25f, 0.3f, 1e30f});
+  std::vector<double> doubles{-1.5, 0.0, 0.25, 0.25, 3.0, 1e300, -1e300, 2.0};
+  CheckSimdSearch(doubles, {-2.0, 0.0, 0.25, 0.3, 1e300});
+}
+
+TEST(simd_search_test, containers_with_arithmetic_keys) {
+  s21::btree_multiset<uint64_t> tree;
+  s21::flat_multiset<double> flat;
+  std::multiset<uint64_t> origin;
+  for (uint64_t i = 0; i < 3000; ++i) {
+    uint64_t key{(i * 2654435761ULL) % 997 << 54};
+    tree.insert(key);
+    flat.insert(static_cast<double>(key));
+    origin.insert(key);
+  }
+  EXPECT_TRUE(tree.CheckBalance());
+  for (uint64_t i = 0; i < 1000; ++i) {
+    uint64_t key{i << 54};
+    EXPECT_EQ(tree.count(key), origin.count(key));
+    EXPECT_EQ(flat.count(static_cast<double>(key)), origin.count(key));
+  }
+  auto it = tree.begin();
+  for (uint64_t key : origin) EXPECT_EQ(*it++, key);
+}
+
+struct string_hash {
+  using is_transparent = void;
+  size_t operator()(std::string_view key) const {
+    return std::hash<std::string_view>()(key);
+  }
+};
+
+TEST(unordered_test, random_against_std) {
+  s21::unordered_set<int> s1;
+  std::unordered_set<int> s2;
+  unsigned seed{23};
+  for (int i = 0; i < 50000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int value = static_cast<int>(seed >> 12) % 5000 * 64;
+    if (i % 3 == 2 && s1.contains(value)) {
+      s1.erase(s1.find(value));
+      s2.erase(value);
+    } else {
+      EXPECT_EQ(s1.insert(value).second, s2.insert(value).second);
+      EXPECT_EQ(*s1.find(value), value);
+    }
+  }
+  ASSERT_EQ(s1.size(), s2.size());
+  size_t walked{0};
+  for (int value : s1) {
+    EXPECT_EQ(s2.count(value), 1U);
+    walked++;
+  }
+  EXPECT_EQ(walked, s2.size());
+  for (int value = -64; value < 5000 * 64; value += 64)
+    EXPECT_EQ(s1.count(value), s2.count(value));
+  EXPECT_LE(s1.load_factor(), 0.875f);
+}
+
+TEST(unordered_test, set_copy_reserve_merge) {
+  s21::unordered_set<std::string> s1 = {"a", "b", "c"};
+  s1.reserve(1000);
+  size_t capacity{s1.capacity()};
+  for (int i = 0; i < 1000; ++i) s1.insert("key-" + std::to_string(i));
+  EXPECT_EQ(s1.capacity(), capacity);
+  EXPECT_EQ(s1.size(), 1003U);
+
+  s21::unordered_set<std::string> s2(s1);
+  s2.erase(s2.find("a"));
+  EXPECT_TRUE(s1.contains("a"));
+  EXPECT_FALSE(s2.contains("a"));
+
+  s21::unordered_set<std::string> s3 = {"a", "b", "new"};
+  s2.merge(s3);
+  EXPECT_EQ(s2.size(), 1004U);
+  EXPECT_EQ(s3.size(), 1U);
+  EXPECT_TRUE(s3.contains("b"));
+  s1 = std::move(s2);
+  EXPECT_TRUE(s1.contains("new"));
+  s1.clear();
+  EXPECT_TRUE(s1.empty());
+  EXPECT_EQ(s1.begin(), s1.end());
+  EXPECT_FALSE(s1.contains("new"));
+}
+
+TEST(unordered_test, tombstones_rehash_in_place) {
+  // values fill 96 of 128 slots, so churn only piles up tombstones, which
+  // a rehash at the same capacity clears
+  s21::unordered_set<int> s1;
+  s1.reserve(96);
+  EXPECT_EQ(s1.capacity(), 128U);
+  for (int i = 0; i < 96; ++i) s1.insert(i);
+  for (int i = 96; i < 10000; ++i) {
+    s1.erase(s1.find(i - 96));
+    s1.insert(i);
+  }
+  EXPECT_EQ(s1.capacity(), 128U);
+  EXPECT_EQ(s1.size(), 96U);
+  // past 13/16 of the slots in values the table doubles
+  for (int i = 1; i <= 20; ++i) s1.insert(-i);
+  EXPECT_EQ(s1.capacity(), 256U);
+  EXPECT_EQ(s1.size(), 116U);
+}
+
+// a key whose copies and moves throw while throws is set
+struct throwing_key {
+  static bool throws;
+  int key{0};
+  explicit throwing_key(int k) : key{k} {}
+  throwing_key(const throwing_key& other) : key{other.key} {
+    if (throws) throw std::runtime_error("copy");
+  }
+  throwing_key(throwing_key&& other) : key{other.key} {
+    if (throws) throw std::runtime_error("move");
+  }
+  bool operator==(const throwing_key& other) const {
+    return key == other.key;
+  }
+};
+bool throwing_key::throws{false};
+
+struct throwing_key_hash {
+  size_t operator()(const throwing_key& value) const {
+    return std::hash<int>()(value.key);
+  }
+};
+
+TEST(unordered_test, rehash_throws_leaves_table) {
+  s21::unordered_set<throwing_key, throwing_key_hash> s1;
+  for (int i = 0; i < 10; ++i) s1.emplace(i);
+  size_t capacity{s1.capacity()};
+
+  throwing_key::throws = true;
+  EXPECT_THROW(s1.reserve(1000), std::runtime_error);
+  throwing_key::throws = false;
+  EXPECT_EQ(s1.capacity(), capacity);
+  EXPECT_EQ(s1.size(), 10U);
+  for (int i = 0; i < 10; ++i) EXPECT_TRUE(s1.contains(throwing_key(i)));
+  int sum{0};
+  for (const throwing_key& value : s1) sum += value.key;
+  EXPECT_EQ(sum, 45);
+
+  s1.reserve(1000);
+  EXPECT_GT(s1.capacity(), capacity);
+  for (int i = 0; i < 10; ++i) EXPECT_TRUE(s1.contains(throwing_key(i)));
+}
+
+TEST(unordered_test, insert_many_iterators) {
+  // the 15th value outgrows the first 16 slots
+  s21::unordered_set<int> s1;
+  auto r1 = s1.insert_many(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                           16, 1);
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(*r1[i].first, i + 1);
+    EXPECT_TRUE(r1[i].second);
+  }
+  EXPECT_EQ(*r1[16].first, 1);
+  EXPECT_FALSE(r1[16].second);
+
+  s21::unordered_map<int, int> m1;
+  for (int i = 0; i < 13; ++i) m1.insert(100 + i, i);
+  auto r2 = m1.insert_many(std::make_pair(1, 10), std::make_pair(2, 20),
+                           std::make_pair(1, 0));
+  EXPECT_EQ(r2[0].first->second, 10);
+  EXPECT_EQ(r2[1].first->second, 20);
+  EXPECT_EQ(r2[2].first->second, 10);
+  EXPECT_FALSE(r2[2].second);
+}
+
+TEST(unordered_test, map_interface) {
+  s21::unordered_map<int, std::string> test = {{2, "b"}, {1, "a"}};
+  std::unordered_map<int, std::string> origin = {{2, "b"}, {1, "a"}};
+  for (int i = 0; i < 2000; ++i) {
+    test[i * 3 % 1000] += "x";
+    origin[i * 3 % 1000] += "x";
+  }
+  EXPECT_FALSE(test.insert(1, "q").second);
+  test.insert_or_assign(1, "q");
+  origin[1] = "q";
+  EXPECT_EQ(test.at(1), "q");
+  EXPECT_THROW(test.at(1000), std::invalid_argument);
+  ASSERT_EQ(test.size(), origin.size());
+  for (const auto& item : origin) EXPECT_EQ(test.at(item.first), item.second);
+
+  s21::unordered_map<std::string, int, string_hash, std::equal_to<>> words;
+  words.insert("alpha", 1);
+  words.emplace("beta", 2);
+  EXPECT_EQ(words.at(std::string_view("beta")), 2);
+  EXPECT_TRUE(words.contains("alpha"));
+  EXPECT_EQ(words.find(std::string_view("gamma")), words.end());
+}
+
+TEST(concurrent_map_test, threads_and_ordered_walk) {
+  s21::concurrent_map<int, int> map(8);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&map, t] {
+      for (int i = t; i < 4000; i += 4) {
+        EXPECT_TRUE(map.insert(i, i * 2));
+        EXPECT_EQ(map.find(i).value_or(-1), i * 2);
+      }
+      for (int i = t; i < 4000; i += 8) EXPECT_TRUE(map.erase(i));
+    });
+  }
+  for (std::thread& worker : workers) worker.join();
+  EXPECT_EQ(map.size(), 2000U);
+  EXPECT_FALSE(map.contains(0));
+  EXPECT_TRUE(map.contains(4));
+  EXPECT_FALSE(map.find(8).has_value());
+
+  int previous{-1};
+  size_t walked{0};
+  map.for_each([&](const int& key, const int& value) {
+    EXPECT_LT(previous, key);
+    EXPECT_EQ(value, key * 2);
+    previous = key;
+    walked++;
+  });
+  EXPECT_EQ(walked, 2000U);
+  s21::map<int, int> copy{map.snapshot()};
+  EXPECT_EQ(copy.size(), 2000U);
+  EXPECT_EQ(copy.begin()->first, 4);
+}
+
+TEST(concurrent_map_test, insert_many_and_rw_mode) {
+  s21::concurrent_rw_map<std::string, int> map(4);
+  std::vector<std::pair<std::string, int>> batch;
+  for (int i = 0; i < 100; ++i) batch.emplace_back(std::to_string(i), i);
+  batch.emplace_back("7", -1);
+  EXPECT_EQ(map.insert_many(batch.begin(), batch.end()), 100U);
+  EXPECT_EQ(map.find("7").value(), 7);
+  EXPECT_EQ(map.insert_many({{"7", 0}, {"x", 1}}), 1U);
+  EXPECT_TRUE(map.update("x", [](int& value) { value += 10; }));
+  EXPECT_FALSE(map.update("y", [](int& value) { value += 10; }));
+  EXPECT_EQ(map.find("x").value(), 11);
+  map.insert_or_assign("x", 3);
+
+  std::vector<std::thread> readers;
+  std::atomic<int> found{0};
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&map, &found] {
+      for (int i = 0; i < 100; ++i) found += map.contains(std::to_string(i));
+    });
+  }
+  for (std::thread& reader : readers) reader.join();
+  EXPECT_EQ(found.load(), 400);
+  EXPECT_EQ(map.find("x").value(), 3);
+  map.clear();
+  EXPECT_TRUE(map.empty());
+}
+
+// a hasher and a comparator that only work as constructed, not defaulted
+struct counting_hash {
+  std::atomic<int>* calls{nullptr};
+  size_t operator()(int key) const {
+    ++*calls;
+    return std::hash<int>()(key);
+  }
+};
+
+struct flag_compare {
+  bool descending{false};
+  bool operator()(int a, int b) const { return descending ? b < a : a < b; }
+};
+
+TEST(concurrent_map_test, stateful_hash_and_compare) {
+  std::atomic<int> calls{0};
+  s21::concurrent_map<int, int, flag_compare, counting_hash> map(
+      4, counting_hash{&calls}, flag_compare{true});
+  std::vector<std::pair<int, int>> batch;
+  for (int i = 0; i < 100; ++i) batch.emplace_back(i, i);
+  EXPECT_EQ(map.insert_many(batch.begin(), batch.end()), 100U);
+  EXPECT_TRUE(map.contains(42));
+  EXPECT_EQ(calls.load(), 101);
+  EXPECT_TRUE(map.key_comp().descending);
+
+  int previous{100};
+  map.for_each([&previous](const int& key, const int&) {
+    EXPECT_EQ(key, previous - 1);
+    previous = key;
+  });
+  EXPECT_EQ(previous, 0);
+  s21::map<int, int, flag_compare> copy{map.snapshot()};
+  EXPECT_EQ(copy.begin()->first, 99);
+}
+
+// the walk runs on a copy, so the callback may write to the map
+TEST(concurrent_map_test, for_each_calls_back_into_map) {
+  s21::concurrent_map<int, int> map(4);
+  for (int i = 0; i < 50; ++i) map.insert(i, i);
+  int walked{0};
+  map.for_each([&map, &walked](const int& key, const int& value) {
+    EXPECT_TRUE(map.erase(key));
+    map.insert(key + 1000, value);
+    walked++;
+  });
+  EXPECT_EQ(walked, 50);
+  EXPECT_EQ(map.size(), 50U);
+  EXPECT_FALSE(map.contains(0));
+  EXPECT_TRUE(map.contains(1049));
+}
+
+TEST(persistent_set_test, random_against_std) {
+  s21::persistent_set<int> s1;
+  std::set<int> s2;
+  unsigned seed{29};
+  for (int i = 0; i < 20000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int value = static_cast<int>(seed >> 16) % 3000;
+    if (i % 3 == 2) {
+      EXPECT_EQ(s1.erase(value), s2.erase(value) == 1);
+    } else {
+      auto result = s1.insert(value);
+      EXPECT_EQ(result.second, s2.insert(value).second);
+      EXPECT_EQ(*result.first, value);
+    }
+  }
+  EXPECT_TRUE(s1.CheckBalance());
+  ASSERT_EQ(s1.size(), s2.size());
+  auto it1 = s1.begin();
+  for (auto it2 = s2.begin(); it2 != s2.end(); ++it1, ++it2)
+    EXPECT_EQ(*it1, *it2);
+  EXPECT_EQ(it1, s1.end());
+  for (int key = -1; key <= 3001; key += 13) {
+    auto lower = s2.lower_bound(key);
+    if (lower == s2.end()) {
+      EXPECT_EQ(s1.lower_bound(key), s1.end());
+    } else {
+      EXPECT_EQ(*s1.lower_bound(key), *lower);
+    }
+    EXPECT_EQ(s1.contains(key), s2.count(key) == 1);
+  }
+}
+
+TEST(persistent_set_test, snapshots_are_frozen) {
+  s21::persistent_set<std::string> live = {"b", "d"};
+  s21::persistent_set<std::string> before{live.snapshot()};
+  auto it = live.find("b");
+  live.insert("a");
+  live.erase("d");
+  live.insert("c");
+  EXPECT_EQ(*it, "b");
+  EXPECT_EQ(*++it, "d");
+  EXPECT_EQ(before.size(), 2U);
+  EXPECT_TRUE(before.contains("d"));
+  EXPECT_FALSE(before.contains("a"));
+  std::string joined;
+  for (const std::string& key : live) joined += key;
+  EXPECT_EQ(joined, "abc");
+  live.clear();
+  EXPECT_EQ(before.size(), 2U);
+}
+
+TEST(persistent_set_test, readers_during_writes) {
+  s21::persistent_set<int> live;
+  std::atomic<bool> done{false};
+  std::atomic<int> bad{0};
+  std::thread reader([&] {
+    while (!done) {
+      s21::persistent_set<int> view{live.snapshot()};
+      size_t walked{0};
+      int previous{-1};
+      for (int value : view) {
+        bad += value <= previous;
+        previous = value;
+        walked++;
+      }
+      bad += walked != view.size();
+    }
+  });
+  for (int i = 0; i < 3000; ++i) {
+    live.insert(i);
+    if (i % 4 == 0) live.erase(i / 2);
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(bad.load(), 0);
+  EXPECT_TRUE(live.CheckBalance());
+}
+
 TEST(s_vector_test, castop) {
   s21::vector<int> vector{1, 3, 9, 12, 0, 12, 144};
   std::vector<int> vector_2{1, 3, 9, 12, 0, 12, 144};
@@ -1941,6 +3741,9 @@ TEST(s_vector_test, move) {
   for (size_t i{0}; i < vector2.size(); ++i) {
     EXPECT_EQ(vector2[i], 4);
   }
+  EXPECT_EQ(vector1.size(), 0U);
+  vector1.push_back(1);
+  EXPECT_EQ(vector1[0], 1);
 }
 
 TEST(s_vector_test, move_equal) {
@@ -1950,6 +3753,7 @@ TEST(s_vector_test, move_equal) {
   for (size_t i{0}; i < vector2.size(); ++i) {
     EXPECT_EQ(vector2[i], 4);
   }
+  EXPECT_EQ(vector1.size(), 0U);
 }
 
 TEST(s_vector_test, access0) {
@@ -2022,7 +3826,7 @@ TEST(set_test_part3, insert_many4_duplicate) {
   s21::set<int> a{1};
   auto v = a.insert_many(1, 2);
   vector<std::pair<s21::set<int>::iterator, bool>> v2;
-  v2.push_back(std::make_pair(a.end(), false));
+  v2.push_back(std::make_pair(a.find(1), false));
   v2.push_back(std::make_pair(a.find(2), true));
   auto it2 = v2.begin();
   for (auto it = v.begin(); it != v.end(); ++it, ++it2) EXPECT_EQ(*it, *it2);
@@ -2066,7 +3870,7 @@ TEST(multiset_test_part3, insert_many4_duplicate) {
   s21::multiset<int> a{1};
   auto v = a.insert_many(1, 2);
   vector<std::pair<s21::multiset<int>::iterator, bool>> v2;
-  v2.push_back(std::make_pair(a.lower_bound(1), true));
+  v2.push_back(std::make_pair(++a.lower_bound(1), true));
   v2.push_back(std::make_pair(a.find(2), true));
   auto it2 = v2.begin();
   for (auto it = v.begin(); it != v.end(); ++it, ++it2) EXPECT_EQ(*it, *it2);
@@ -2221,6 +4025,17 @@ TEST(s_map, begin_plus_plus) {
   EXPECT_EQ(start->second, start_original->second);
 }
 
+TEST(s_map, end_decrement) {
+  s21::map<int, char> test = {{1, 'a'}, {6, 'b'}, {3, 'c'}};
+  auto last = --test.end();
+  EXPECT_EQ(last->first, 6);
+  test.erase(last);
+  EXPECT_EQ((--test.end())->first, 3);
+  test.insert(9, 'd');
+  EXPECT_EQ((--test.end())->second, 'd');
+  EXPECT_TRUE(test.CheckBalance());
+}
+
 TEST(s_map, size_max_size) {
   s21::map<char, int> test = {{'q', 1}, {'w', 2}, {'e', 3}};
   std::map<char, int> origin = {{'q', 1}, {'w', 2}, {'e', 3}};
@@ -2285,6 +4100,119 @@ TEST(s_map, merge) {
   }
 }
 
+TEST(s_map, merge_splices_nodes) {
+  s21::map<int, std::string> test = {{1, "a"}, {3, "c"}};
+  const std::string* moved{nullptr};
+  {
+    s21::map<int, std::string> test1 = {{1, "x"}, {2, "b"}};
+    moved = &test1.at(2);
+    test.merge(test1);
+    EXPECT_EQ(test1.size(), 1U);
+    EXPECT_EQ(test1.at(1), "x");
+  }
+  EXPECT_EQ(&test.at(2), moved);
+  EXPECT_EQ(test.at(2), "b");
+  EXPECT_EQ(test.at(1), "a");
+  EXPECT_EQ(test.size(), 3U);
+}
+
+TEST(s_map, transparent_lookup) {
+  s21::map<std::string, int, std::less<>> test = {{"/api", 1}, {"/web", 2}};
+  std::string_view path{"/web/index"};
+  EXPECT_EQ(test.at(path.substr(0, 4)), 2);
+  EXPECT_TRUE(test.contains("/api"));
+  EXPECT_EQ(test.find(path), test.end());
+  EXPECT_THROW(test.at(std::string_view("/none")), std::invalid_argument);
+  EXPECT_EQ(test["/api"], 1);
+}
+
+TEST(s_map, custom_compare) {
+  s21::map<int, char, std::greater<int>> test = {{1, 'a'}, {3, 'c'}};
+  test.insert(2, 'b');
+  std::string order;
+  for (auto &item : test) order += item.second;
+  EXPECT_EQ(order, "cba");
+}
+
+TEST(s_map, order_statistics) {
+  std::vector<std::pair<int, int>> sorted;
+  for (int i = 0; i < 100; ++i) sorted.push_back({i * 10, i});
+  s21::ranked_map<int, int> latency;
+  latency.build_from_sorted(sorted.begin(), sorted.end());
+  latency.insert(5, -1);
+  latency.erase(latency.find(990));
+  EXPECT_TRUE(latency.CheckBalance());
+  EXPECT_EQ(latency.nth(0)->first, 0);
+  EXPECT_EQ(latency.nth(1)->first, 5);
+  EXPECT_EQ(latency.nth(latency.size() / 2)->first, 490);
+  EXPECT_EQ(latency.nth(latency.size() - 1)->first, 980);
+  EXPECT_EQ(latency.rank(500), 51U);
+  EXPECT_EQ(latency.count_range(5, 30), 3U);
+}
+
+TEST(s_map, bounds) {
+  s21::map<int, char> test = {{1, 'a'}, {5, 'e'}, {9, 'i'}};
+  EXPECT_EQ(test.lower_bound(4)->second, 'e');
+  EXPECT_EQ(test.upper_bound(5)->second, 'i');
+  EXPECT_EQ(test.lower_bound(10), test.end());
+  auto range = test.equal_range(5);
+  EXPECT_EQ(range.first->second, 'e');
+  EXPECT_EQ(range.second->second, 'i');
+  EXPECT_EQ(test.count(5), 1U);
+  EXPECT_EQ(test.count(6), 0U);
+}
+
+TEST(s_map, balance_sorted_insert) {
+  s21::map<int, int> test;
+  for (int i = 0; i < 3000; ++i) test.insert(i, i * 2);
+  EXPECT_TRUE(test.CheckBalance());
+  EXPECT_EQ(test.size(), 3000U);
+  EXPECT_EQ(test.at(2999), 5998);
+}
+
+TEST(s_map, key_only_order) {
+  struct no_less {
+    int value;
+  };
+  s21::map<int, no_less> test;
+  test.insert(2, {20});
+  test.insert(1, {10});
+  auto res = test.insert(2, {30});
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ(res.first->second.value, 20);
+  EXPECT_EQ(test.size(), 2U);
+  EXPECT_EQ(test.begin()->first, 1);
+  EXPECT_EQ(test[2].value, 20);
+}
+
+TEST(s_map, lookup_large) {
+  s21::map<int, std::string> test;
+  std::map<int, std::string> origin;
+  for (int i = 0; i < 20000; ++i) {
+    test[i * 7 % 20011] = std::to_string(i);
+    origin[i * 7 % 20011] = std::to_string(i);
+  }
+  EXPECT_EQ(test.size(), origin.size());
+  for (int i = 0; i < 20011; i += 13) {
+    EXPECT_EQ(test.contains(i), origin.count(i) == 1);
+    if (origin.count(i)) {
+      EXPECT_EQ(test.at(i), origin.at(i));
+    }
+  }
+  EXPECT_EQ(test.find(20011), test.end());
+  EXPECT_ANY_THROW(test.at(-1));
+  EXPECT_TRUE(test[-1].empty());
+}
+
+TEST(s_map, reserve) {
+  s21::map<int, std::string> test;
+  test.reserve(100);
+  auto capacity = test.capacity();
+  for (int i = 0; i < 100; ++i) test[i] = std::to_string(i);
+  EXPECT_EQ(test.capacity(), capacity);
+  EXPECT_EQ(test.at(42), "42");
+}
+
 TEST(s_map, contains) {
   s21::map<int, float> test = {{1, 2.2}, {6, 2.2}, {3, 0.2}};
   EXPECT_EQ(test.contains(6), 1);
@@ -2310,6 +4238,126 @@ TEST(s_map, insert) {
   }
 }
 
+TEST(s_map, emplace) {
+  s21::map<int, std::string> test;
+  auto res1 = test.emplace(1, "one");
+  EXPECT_TRUE(res1.second);
+  EXPECT_EQ(res1.first->second, "one");
+  auto res2 = test.emplace(std::make_pair(1, std::string("uno")));
+  EXPECT_FALSE(res2.second);
+  EXPECT_EQ(res2.first, res1.first);
+  auto res3 = test.try_emplace(2, 3, '2');
+  EXPECT_TRUE(res3.second);
+  EXPECT_EQ(test.at(2), "222");
+  auto res4 = test.try_emplace(2, 1, 'x');
+  EXPECT_FALSE(res4.second);
+  EXPECT_EQ(test.at(2), "222");
+  EXPECT_TRUE(test.CheckBalance());
+}
+
+TEST(s_map, insert_hint) {
+  s21::map<int, int> test;
+  for (int i = 0; i < 1000; ++i) test.emplace_hint(test.end(), i, i * i);
+  auto it = test.insert(test.begin(), {500, 0});
+  EXPECT_EQ(it->second, 250000);
+  it = test.insert(test.find(10), {-1, 1});
+  EXPECT_EQ(it, test.begin());
+  EXPECT_EQ(test.size(), 1001U);
+  EXPECT_TRUE(test.CheckBalance());
+}
+
+TEST(s_map, build_from_sorted) {
+  std::map<int, std::string> origin;
+  for (int i = 0; i < 1000; ++i) origin[i] = std::to_string(i);
+  s21::map<int, std::string> test(origin.begin(), origin.end());
+  EXPECT_EQ(test.size(), origin.size());
+  EXPECT_TRUE(test.CheckBalance());
+  EXPECT_EQ(test.at(999), "999");
+  std::vector<std::pair<int, std::string>> items = {
+      {1, "a"}, {1, "b"}, {2, "c"}};
+  test.build_from_sorted(items.begin(), items.end());
+  EXPECT_EQ(test.size(), 2U);
+  EXPECT_EQ(test.at(1), "a");
+}
+
+TEST(s_map, from_unsorted) {
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < 100000; ++i) items.push_back({i * 7919 % 40000, i});
+  s21::map<int, int> test =
+      s21::map<int, int>::from_unsorted(items.begin(), items.end(), 4);
+  EXPECT_EQ(test.size(), 40000U);
+  EXPECT_TRUE(test.CheckBalance());
+  // the first pair of every key wins, as with repeated inserts
+  std::map<int, int> origin;
+  for (const auto &item : items) origin.insert(item);
+  auto it = test.begin();
+  for (const auto &item : origin) {
+    EXPECT_EQ(it->first, item.first);
+    EXPECT_EQ(it->second, item.second);
+    ++it;
+  }
+
+  std::vector<std::pair<std::string, int>> words = {
+      {"pear", 1}, {"apple", 2}, {"pear", 3}};
+  auto fruit = s21::map<std::string, int>::from_unsorted(words.begin(),
+                                                         words.end());
+  EXPECT_EQ(fruit.size(), 2U);
+  EXPECT_EQ(fruit.at("pear"), 1);
+  EXPECT_EQ(fruit.begin()->first, "apple");
+}
+
+TEST(s_map, parallel_reduce_histogram) {
+  s21::map<int, int> test;
+  for (int i = 0; i < 100000; ++i) test.insert(i, i % 10);
+  using histogram = std::array<int, 10>;
+  histogram counts{test.parallel_reduce(
+      histogram{},
+      [](histogram partial, const std::pair<int, int> &item) {
+        partial[item.second]++;
+        return partial;
+      },
+      [](histogram a, const histogram &b) {
+        for (size_t i = 0; i < a.size(); ++i) a[i] += b[i];
+        return a;
+      },
+      4)};
+  for (int count : counts) EXPECT_EQ(count, 10000);
+
+  std::atomic<int> odd{0};
+  test.parallel_for_each(
+      [&odd](const std::pair<int, int> &item) { odd += item.first % 2; });
+  EXPECT_EQ(odd, 50000);
+}
+
+TEST(s_map, set_algebra) {
+  s21::map<int, std::string> first = {{1, "a1"}, {2, "a2"}, {3, "a3"}};
+  s21::map<int, std::string> second = {{2, "b2"}, {3, "b3"}, {4, "b4"}};
+  s21::map<int, std::string> u{s21::set_union(first, second)};
+  EXPECT_EQ(u.size(), 4U);
+  EXPECT_EQ(u.at(2), "a2");
+  EXPECT_EQ(u.at(4), "b4");
+  s21::map<int, std::string> i{s21::set_intersection(first, second)};
+  EXPECT_EQ(i.size(), 2U);
+  EXPECT_EQ(i.at(3), "a3");
+  s21::map<int, std::string> d{s21::set_difference(first, second)};
+  EXPECT_EQ(d.size(), 1U);
+  EXPECT_EQ(d.begin()->second, "a1");
+
+  first.unite(second);
+  EXPECT_EQ(first.size(), 4U);
+  EXPECT_EQ(second.size(), 3U);
+  EXPECT_TRUE(first.CheckBalance());
+
+  // a larger rvalue keeps its nodes, the pairs of this map still win
+  s21::map<int, std::string> small = {{3, "s3"}};
+  small.unite(std::move(first));
+  EXPECT_EQ(small.size(), 4U);
+  EXPECT_TRUE(first.empty());
+  EXPECT_EQ(small.at(3), "s3");
+  EXPECT_EQ(small.at(1), "a1");
+  EXPECT_TRUE(small.CheckBalance());
+}
+
 TEST(s_map, insert_or_assign) {
   std::map<int, int> test1 = {{{1, 2}, {6, 2}, {3, 0}}};
   s21::map<int, int> test2 = {{{1, 2}, {6, 2}, {3, 0}}};